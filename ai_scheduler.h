@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+#include "components.h"
+#include "settings.h"
+
+const Uint32 AI_NEARBY_INTERVAL = 4;  // ticks between updates for idle enemies outside notice range
+const int AI_WAKE_MARGIN = TILESIZE * 2;
+
+enum class AiTier {
+    Active,  // inside notice range or busy: every tick
+    Nearby,  // idle inside the wake area: every AI_NEARBY_INTERVAL ticks
+    Asleep   // outside the wake area: not touched at all
+};
+
+struct AiTierStats {
+    int active = 0;
+    int nearby_updated = 0;
+    int nearby_skipped = 0;
+    int asleep = 0;
+};
+
+// Half-size of the area around the player where enemies are awake: the view,
+// or the largest notice radius if that reaches further, plus a margin. Fixed
+// for a run; Level works it out once.
+SDL_Point ai_wake_extent() {
+    int notice = 0;
+    for (const auto& entry : monster_data) notice = std::max(notice, entry.second.notice_radius);
+    return { std::max(WIDTH / 2, notice) + AI_WAKE_MARGIN, std::max(HEIGHT / 2, notice) + AI_WAKE_MARGIN };
+}
+
+// Picks which enemies the systems run this tick. Only enemies inside the wake
+// area are looked at, so sleepers cost nothing; one that wakes up, or comes
+// back from a long skip, restarts with a one-tick step instead of catching up.
+class AiScheduler {
+public:
+    // `awake` holds the slot of every enemy inside the wake area.
+    // Returns the slots to update, ascending; each one's `elapsed` is set.
+    const std::vector<size_t>& schedule(EnemyStore& store, const std::vector<size_t>& awake,
+                                        SDL_Point player_center, Uint32 tick) {
+        scheduled.clear();
+        stats = {};
+
+        // Killed enemies stay in the store until the end-of-tick flush; they are in no tier
+        int awake_alive = 0;
+
+        for (size_t i : awake) {
+            if (!store.combat[i].alive) continue;
+            awake_alive++;
+            ActivityComponent& activity = store.activity[i];
+            Uint32 since = tick - activity.last_tick;
+            bool woke = since > AI_NEARBY_INTERVAL;
+
+            AiTier tier = tierOf(store, i, player_center);
+            if (tier == AiTier::Nearby && since < AI_NEARBY_INTERVAL) {
+                stats.nearby_skipped++;
+                continue;
+            }
+
+            if (tier == AiTier::Active) stats.active++;
+            else stats.nearby_updated++;
+            activity.elapsed = woke ? 1 : since;
+            activity.last_tick = tick;
+            scheduled.push_back(i);
+        }
+
+        stats.asleep = static_cast<int>(store.liveCount()) - awake_alive;
+        std::sort(scheduled.begin(), scheduled.end());
+        return scheduled;
+    }
+
+    const AiTierStats& getStats() const { return stats; }
+
+private:
+    static AiTier tierOf(const EnemyStore& store, size_t i, SDL_Point player_center) {
+        const AIComponent& ai = store.ai[i];
+        const MotionComponent& motion = store.motion[i];
+        if (ai.state != EnemyState::Idle || ai.attacking || !store.combat[i].vulnerable ||
+            motion.knockback.x != 0.0f || motion.knockback.y != 0.0f) {
+            return AiTier::Active;
+        }
+
+        const SDL_Rect& rect = store.transforms[i].rect;
+        float dx = player_center.x - (rect.x + rect.w / 2.0f);
+        float dy = player_center.y - (rect.y + rect.h / 2.0f);
+        float notice = static_cast<float>(store.archetypes[i]->stats.notice_radius);
+        return (dx * dx + dy * dy <= notice * notice) ? AiTier::Active : AiTier::Nearby;
+    }
+
+    std::vector<size_t> scheduled;
+    AiTierStats stats;
+};
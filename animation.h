@@ -0,0 +1,51 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "texture_cache.h"
+
+// All frames of one animation, uploaded to the GPU once at load time.
+// Animating only has to pick a frame index; no surfaces are kept around.
+struct AnimationClip {
+    std::vector<std::shared_ptr<SDL_Texture>> frames;
+    std::vector<SDL_Point> sizes;
+
+    size_t size() const { return frames.size(); }
+    bool empty() const { return frames.empty(); }
+};
+
+// Loads every image in `folder` (sorted by filename) through the texture cache,
+// so entities of the same kind share their frames.
+AnimationClip load_animation_clip(SDL_Renderer* renderer, const std::string& folder) {
+    AnimationClip clip;
+
+    std::error_code ec;
+    if (!std::filesystem::exists(folder, ec)) {
+        std::cerr << "load_animation_clip: missing animation folder at: " << folder << "\n";
+        return clip;
+    }
+
+    std::vector<std::filesystem::directory_entry> entries;
+    for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+        if (entry.is_regular_file()) entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+        [](const auto& a, const auto& b) {
+            return a.path().filename() < b.path().filename();
+        });
+
+    for (const auto& entry : entries) {
+        auto texture = texture_cache.load(renderer, entry.path().string());
+        if (!texture) continue;
+
+        clip.sizes.push_back(texture_size(texture));
+        clip.frames.push_back(std::move(texture));
+    }
+
+    return clip;
+}
@@ -0,0 +1,728 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "player.h"
+#include "ai_scheduler.h"
+#include "collision_grid.h"
+#include "pathfinder.h"
+#include "hierarchical_pathfinder.h"
+#include "flow_field.h"
+#include "enemy_systems.h"
+#include "job_system.h"
+#include "spatial_hash.h"
+
+enum class BenchPhase {
+    Update,
+    Collision,
+    Cull,
+    Sort,
+    Draw,
+    UI,
+    Count
+};
+
+const char* bench_phase_name(BenchPhase phase) {
+    switch (phase) {
+        case BenchPhase::Update:    return "update";
+        case BenchPhase::Collision: return "collision";
+        case BenchPhase::Cull:      return "cull";
+        case BenchPhase::Sort:      return "sort";
+        case BenchPhase::Draw:      return "draw";
+        case BenchPhase::UI:        return "ui";
+        default:                    return "?";
+    }
+}
+
+double ticks_to_ms(Uint64 ticks) {
+    return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// Per-phase frame timings collected by the headless benchmark.
+class BenchTimings {
+public:
+    void record(BenchPhase phase, double ms) {
+        samples[static_cast<size_t>(phase)].push_back(ms);
+    }
+
+    void report(std::ostream& out) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "%-10s %10s %10s %10s\n", "phase", "min ms", "median ms", "p99 ms");
+        out << line;
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            auto& values = samples[i];
+            if (values.empty()) continue;
+
+            std::sort(values.begin(), values.end());
+            double min = values.front();
+            double median = values[values.size() / 2];
+            double p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+
+            std::snprintf(line, sizeof(line), "%-10s %10.3f %10.3f %10.3f\n",
+                          bench_phase_name(static_cast<BenchPhase>(i)), min, median, p99);
+            out << line;
+        }
+    }
+
+private:
+    std::array<std::vector<double>, static_cast<size_t>(BenchPhase::Count)> samples;
+};
+
+// Average enemies per tick in each scheduler tier over `ticks` ticks
+void report_ai_tiers(std::ostream& out, const AiTierStats& totals, int ticks) {
+    if (ticks <= 0) return;
+    char line[160];
+    std::snprintf(line, sizeof(line), "ai tiers per tick: %.1f active, %.1f nearby updated, %.1f nearby skipped, %.1f asleep\n",
+                  static_cast<double>(totals.active) / ticks, static_cast<double>(totals.nearby_updated) / ticks,
+                  static_cast<double>(totals.nearby_skipped) / ticks, static_cast<double>(totals.asleep) / ticks);
+    out << line;
+}
+
+// Deterministic input for benchmark runs: walks a square, attacking every
+// half second and cycling weapons every few seconds.
+InputState scripted_input(int frame) {
+    InputState input;
+
+    switch ((frame / 120) % 4) {
+        case 0: input.right = true; break;
+        case 1: input.down = true;  break;
+        case 2: input.left = true;  break;
+        case 3: input.up = true;    break;
+    }
+
+    input.attack = (frame % 30) == 0;
+    input.swap_weapon = (frame % 240) == 0;
+    return input;
+}
+
+// Cave-like test map: 45% random fill smoothed by a cellular automaton, walled in.
+// Same seed, same cave.
+CollisionGrid make_cave(int columns, int rows, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> cells(static_cast<size_t>(columns) * rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            bool border = col == 0 || row == 0 || col == columns - 1 || row == rows - 1;
+            cells[row * columns + col] = border || rng() % 100 < 45;
+        }
+    }
+
+    std::vector<uint8_t> next(cells.size());
+    for (int step = 0; step < 4; ++step) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                int walls = 0;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int c = col + dx;
+                        int r = row + dy;
+                        bool outside = c < 0 || r < 0 || c >= columns || r >= rows;
+                        walls += outside || cells[r * columns + c];
+                    }
+                }
+                next[row * columns + col] = walls >= 5;
+            }
+        }
+        cells.swap(next);
+    }
+
+    CollisionGrid grid(columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            if (cells[row * columns + col]) grid.setSolid(col, row);
+        }
+    }
+    return grid;
+}
+
+SDL_Point random_open_cell(const CollisionGrid& grid, std::mt19937& rng) {
+    while (true) {
+        int col = static_cast<int>(rng() % grid.getColumns());
+        int row = static_cast<int>(rng() % grid.getRows());
+        if (!grid.isBlocked(col, row)) return { col, row };
+    }
+}
+
+// A* microbenchmark: random open start/goal pairs on a fixed cave, then the
+// flow field rebuilt at each start.
+// Unreachable pairs are kept; they flood their whole pocket, as in game.
+void bench_pathfinding(std::ostream& out, float flow_range, int size = 512, int searches = 2000) {
+    CollisionGrid cave = make_cave(size, size, 1337);
+    GridPathfinder pathfinder(&cave);
+    std::mt19937 rng(42);
+
+    std::vector<std::pair<SDL_Point, SDL_Point>> queries;
+    for (int i = 0; i < searches; ++i) {
+        SDL_Point start = random_open_cell(cave, rng);
+        queries.push_back({ start, random_open_cell(cave, rng) });
+    }
+
+    std::vector<SDL_Point> path;
+    int found = 0;
+    long long expanded = 0;
+    size_t steps = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& query : queries) {
+        if (pathfinder.findPath(query.first, query.second, path)) {
+            found++;
+            steps += path.size();
+        }
+        expanded += pathfinder.lastExpanded();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "A* on %dx%d cave: %d searches (%d found) in %.3f s\n",
+                  size, size, searches, found, seconds);
+    out << line;
+    std::snprintf(line, sizeof(line), "%.1f searches/s, %.0f nodes expanded and %.0f path cells per search\n",
+                  searches / seconds, static_cast<double>(expanded) / searches,
+                  found ? static_cast<double>(steps) / found : 0.0);
+    out << line;
+
+    // One flow field rebuild per player tile change, at the in-game chase range
+    FlowField field(&cave, flow_range);
+    int reached = 0;
+    begin = std::chrono::steady_clock::now();
+    for (const auto& query : queries) {
+        field.update(query.first);
+        reached += field.lastReached();
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::snprintf(line, sizeof(line), "flow field (%.1f tiles): %.1f rebuilds/s, %.0f cells per rebuild\n",
+                  flow_range, searches / seconds, static_cast<double>(reached) / searches);
+    out << line;
+}
+
+double path_cost(SDL_Point start, const std::vector<SDL_Point>& path) {
+    double cost = 0.0;
+    for (SDL_Point cell : path) {
+        cost += (cell.x != start.x && cell.y != start.y) ? PATH_DIAGONAL_COST : 1.0;
+        start = cell;
+    }
+    return cost;
+}
+
+// Flat A* against HPA* on one big cave: query latency, how much longer the
+// hierarchical paths come out, and the cost of cutting a cell open.
+void bench_hierarchical(std::ostream& out, int size = 2048, int searches = 100) {
+    CollisionGrid cave = make_cave(size, size, 1337);
+    std::mt19937 rng(42);
+
+    auto begin = std::chrono::steady_clock::now();
+    HierarchicalPathfinder hierarchy;
+    hierarchy.build(&cave);
+    double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<std::pair<SDL_Point, SDL_Point>> queries;
+    for (int i = 0; i < searches; ++i) {
+        SDL_Point start = random_open_cell(cave, rng);
+        queries.push_back({ start, random_open_cell(cave, rng) });
+    }
+
+    GridPathfinder flat(&cave);
+    std::vector<SDL_Point> flat_path, hpa_path;
+    double flat_ms = 0.0, hpa_ms = 0.0, flat_cost = 0.0, hpa_cost = 0.0;
+    int found = 0, mismatched = 0;
+    for (const auto& query : queries) {
+        begin = std::chrono::steady_clock::now();
+        bool flat_found = flat.findPath(query.first, query.second, flat_path);
+        auto mid = std::chrono::steady_clock::now();
+        bool hpa_found = hierarchy.findPath(query.first, query.second, hpa_path);
+        auto end = std::chrono::steady_clock::now();
+
+        flat_ms += std::chrono::duration<double, std::milli>(mid - begin).count();
+        hpa_ms += std::chrono::duration<double, std::milli>(end - mid).count();
+        if (flat_found != hpa_found) mismatched++;
+        if (flat_found && hpa_found) {
+            found++;
+            flat_cost += path_cost(query.first, flat_path);
+            hpa_cost += path_cost(query.first, hpa_path);
+        }
+    }
+
+    // Open random walls one at a time, refreshing only the clusters around each
+    const int cuts = 200;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < cuts; ++i) {
+        int col = 1 + static_cast<int>(rng() % (size - 2));
+        int row = 1 + static_cast<int>(rng() % (size - 2));
+        cave.setSolid(col, row, false);
+        hierarchy.refresh(cave.cellRect(col, row));
+    }
+    double refresh_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "HPA* on %dx%d cave: built in %.1f ms, %zu entrance nodes\n",
+                  size, size, build_ms, hierarchy.entranceCount());
+    out << line;
+    std::snprintf(line, sizeof(line), "%-6s %12s %14s\n", "", "avg ms/query", "avg path cost");
+    out << line;
+    std::snprintf(line, sizeof(line), "%-6s %12.3f %14.1f\n", "flat", flat_ms / searches, found ? flat_cost / found : 0.0);
+    out << line;
+    std::snprintf(line, sizeof(line), "%-6s %12.3f %14.1f\n", "hpa", hpa_ms / searches, found ? hpa_cost / found : 0.0);
+    out << line;
+    std::snprintf(line, sizeof(line), "%d/%d found by both, %d disagree on reachability; %.3f ms per cluster refresh\n",
+                  found, searches, mismatched, refresh_ms / cuts);
+    out << line;
+}
+
+// animate() microbenchmark: picking and advancing the player's clip keyed by a
+// "<direction>_<state>" string (built, compared and hashed every tick, as it
+// used to be) against the enum-indexed PlayerClipTable. Frames are never drawn,
+// so no textures are needed.
+void bench_animate(std::ostream& out, int entities = 10000, int ticks = 200) {
+    AnimationClip clip;
+    clip.frames.resize(4);
+    clip.sizes.assign(4, { TILESIZE, TILESIZE });
+
+    std::unordered_map<std::string, AnimationClip> by_name;
+    PlayerClipTable by_index;
+    for (size_t clip_set = 0; clip_set < PLAYER_CLIP_COUNT; ++clip_set) {
+        for (size_t dir = 0; dir < DIRECTION_COUNT; ++dir) {
+            by_name[std::string(direction_name(static_cast<Direction>(dir))) + PLAYER_CLIP_SUFFIX[clip_set]] = clip;
+            by_index[clip_set][dir] = clip;
+        }
+    }
+
+    struct Animated {
+        PlayerActionState action;
+        Direction facing;
+        float frame_index = 0.0f;
+        int current_frame = -1;
+    };
+    struct NamedState {
+        std::string status = "down";
+    };
+    struct IndexedState {
+        PlayerClip clip = PlayerClip::Idle;
+        Direction direction = Direction::Down;
+    };
+
+    // Same inputs for both runs: each entity changes action and facing now and then
+    std::mt19937 rng(7);
+    std::vector<Animated> start(entities);
+    for (Animated& entity : start) {
+        entity.action = static_cast<PlayerActionState>(rng() % 4);
+        entity.facing = static_cast<Direction>(rng() % DIRECTION_COUNT);
+    }
+    auto drive = [](Animated& entity, int tick, size_t index) {
+        if ((tick + index) % 45 == 0) {
+            entity.action = static_cast<PlayerActionState>((static_cast<int>(entity.action) + 1) % 4);
+            entity.facing = static_cast<Direction>((static_cast<int>(entity.facing) + index) % DIRECTION_COUNT);
+        }
+    };
+    auto advance = [](Animated& entity, const AnimationClip& animation) {
+        int anim_size = static_cast<int>(animation.size());
+        entity.frame_index += 0.15f;
+        if (entity.frame_index >= anim_size) entity.frame_index = 0.0f;
+        int new_frame = static_cast<int>(entity.frame_index);
+        if (new_frame != entity.current_frame) entity.current_frame = new_frame;
+    };
+
+    long long named_checksum = 0;
+    std::vector<Animated> named = start;
+    std::vector<NamedState> names(entities);
+    auto begin = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (size_t i = 0; i < named.size(); ++i) {
+            Animated& entity = named[i];
+            drive(entity, tick, i);
+
+            std::string dirStr = direction_name(entity.facing);
+            std::string newStatus;
+            switch (entity.action) {
+                case PlayerActionState::Idle:   newStatus = dirStr + "_idle"; break;
+                case PlayerActionState::Moving: newStatus = dirStr; break;
+                default:                        newStatus = dirStr + "_attack"; break;
+            }
+            if (newStatus != names[i].status) {
+                names[i].status = newStatus;
+                entity.frame_index = 0.0f;
+                entity.current_frame = -1;
+            }
+            advance(entity, by_name[names[i].status]);
+            named_checksum += entity.current_frame;
+        }
+    }
+    double named_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+    long long indexed_checksum = 0;
+    std::vector<Animated> indexed = start;
+    std::vector<IndexedState> states(entities);
+    begin = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (size_t i = 0; i < indexed.size(); ++i) {
+            Animated& entity = indexed[i];
+            drive(entity, tick, i);
+
+            PlayerClip newClip = entity.action == PlayerActionState::Idle   ? PlayerClip::Idle
+                               : entity.action == PlayerActionState::Moving ? PlayerClip::Move
+                                                                            : PlayerClip::Attack;
+            if (newClip != states[i].clip || entity.facing != states[i].direction) {
+                states[i].clip = newClip;
+                states[i].direction = entity.facing;
+                entity.frame_index = 0.0f;
+                entity.current_frame = -1;
+            }
+            advance(entity, by_index[static_cast<size_t>(states[i].clip)][static_cast<size_t>(states[i].direction)]);
+            indexed_checksum += entity.current_frame;
+        }
+    }
+    double indexed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+    double updates = static_cast<double>(entities) * ticks;
+    char line[160];
+    std::snprintf(line, sizeof(line), "animate(), %d entities x %d ticks%s\n", entities, ticks,
+                  named_checksum == indexed_checksum ? "" : " (results differ!)");
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %14s %14s\n", "", "ns/entity", "state bytes");
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %14.1f %14zu\n", "string", named_ns / updates, sizeof(NamedState));
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %14.1f %14zu\n", "enum", indexed_ns / updates, sizeof(IndexedState));
+    out << line;
+}
+
+// Frame-less clip for benchmarks: `frames` tiles-sized frames and no textures
+AnimationClip bench_clip(int frames = 4) {
+    AnimationClip clip;
+    clip.frames.resize(frames);
+    clip.sizes.assign(frames, { TILESIZE, TILESIZE });
+    return clip;
+}
+
+// Sprite handle for enemies a benchmark puts straight into an EnemyStore,
+// standing in for Enemy (which loads its type's assets)
+class BenchEnemyHandle : public Sprite {
+public:
+    BenchEnemyHandle(const EnemyStore& store, size_t slot) : store(&store), slot(slot) {}
+
+    void update() override {}
+    void draw(SDL_Renderer*, SDL_Point) override {}
+    SDL_Rect getRect() const override { return store->transforms[slot].rect; }
+    SDL_Rect getHitbox() const override { return store->transforms[slot].hitbox; }
+
+    const EnemyStore* store;
+    size_t slot;
+};
+
+// `count` enemies of one type on open cells of `cave`, every one of them
+// chasing a player at the cave's center: the worst case for the enemy update.
+// Same seed, same crowd. Needs no window or assets.
+struct BenchCrowd {
+    BenchCrowd(const CollisionGrid& cave, int count, uint32_t seed) {
+        archetype.type = "squid";
+        archetype.stats = monster_data.at("squid");
+        archetype.stats.notice_radius = std::max(cave.getColumns(), cave.getRows()) * TILESIZE;
+        for (AnimationClip& clip : archetype.animations) clip = bench_clip();
+
+        player_center = { cave.getColumns() * TILESIZE / 2, cave.getRows() * TILESIZE / 2 };
+
+        // Handles sit in one block so that the address tie-break in separation
+        // orders them the same way in every crowd built from the same seed
+        std::mt19937 rng(seed);
+        handles.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            SDL_Point cell = random_open_cell(cave, rng);
+            TransformComponent transform;
+            transform.rect = { cell.x * TILESIZE, cell.y * TILESIZE, TILESIZE, TILESIZE };
+            transform.hitbox = { transform.rect.x, transform.rect.y + 10, TILESIZE, TILESIZE - 20 };
+            handles.emplace_back(store, 0);
+            handles.back().slot = store.add(&handles.back(), &handles.back().slot, &archetype, transform);
+            slots.push_back(handles.back().slot);
+        }
+    }
+
+    // One tick of the enemy systems over the whole crowd, as Level::update runs them
+    void tick(EnemyTickContext context, JobSystem& jobs) {
+        crowd.clear();
+        for (size_t i : slots) crowd.insert(store.owners[i], store.transforms[i].hitbox);
+        crowd.build();
+
+        context.player_center = player_center;
+        context.crowd = &crowd;
+        enemy_update(store, slots, context, jobs, intents);
+    }
+
+    EnemyArchetype archetype;
+    EnemyStore store{nullptr};
+    std::vector<BenchEnemyHandle> handles;
+    std::vector<size_t> slots;
+    SDL_Point player_center;
+    SpatialHash crowd;
+    std::vector<EnemyIntent> intents;
+};
+
+// The enemy as it was before EnemyStore: one heap object per enemy behind a
+// shared_ptr, reached through virtual calls, with its own copy of every clip
+// keyed by status string. Behaviour is the old update(), minus path finding
+// (which came later and isn't part of the comparison).
+class LegacyBenchEnemy : public Entity {
+public:
+    LegacyBenchEnemy(const EnemyArchetype& type, const TransformComponent& transform, const CollisionGrid* grid)
+        : enemy_type(type.type), stats(type.stats) {
+        for (size_t state = 0; state < ENEMY_STATE_COUNT; ++state)
+            animations[enemy_state_name(static_cast<EnemyState>(state))] = type.animations[state];
+        rect = transform.rect;
+        hitbox = transform.hitbox;
+        collisionGrid = grid;
+    }
+
+    void update() override {}
+    void draw(SDL_Renderer*, SDL_Point) override {}
+    SDL_Rect getRect() const override { return rect; }
+    SDL_Rect getHitbox() const override { return hitbox; }
+
+    void update(SDL_Point player_center, const SpatialHash& crowd, Uint32 now) {
+        if (!vulnerable && now - last_attacked_time >= invuln_cooldown) vulnerable = true;
+
+        SDL_FPoint diff = {
+            player_center.x - (rect.x + rect.w / 2.0f),
+            player_center.y - (rect.y + rect.h / 2.0f)
+        };
+        float distance = std::sqrt(diff.x * diff.x + diff.y * diff.y);
+        SDL_FPoint direction = {0.0f, 0.0f};
+        if (distance > 0.0f) direction = { diff.x / distance, diff.y / distance };
+        can_attack = (now - last_attack_time >= attack_cooldown);
+
+        if (distance <= stats.attack_radius) {
+            if (can_attack && !attacking) {
+                status = "attack";
+                attacking = true;
+                frame_index = 0.0f;
+            }
+        } else if (distance <= stats.notice_radius) {
+            status = "move";
+        } else {
+            status = "idle";
+        }
+
+        if (knockback.x != 0.0f || knockback.y != 0.0f) {
+            SDL_Point normal = sweepMove(knockback);
+            if (normal.x) knockback.x = 0.0f;
+            if (normal.y) knockback.y = 0.0f;
+            knockback.x *= KNOCKBACK_DECAY;
+            knockback.y *= KNOCKBACK_DECAY;
+            if (std::abs(knockback.x) < 1.0f && std::abs(knockback.y) < 1.0f) knockback = {0.0f, 0.0f};
+        } else if (status == "move") {
+            moveAndCollide(direction.x * stats.speed, direction.y * stats.speed);
+        }
+        separate(crowd);
+        animate(now);
+    }
+
+private:
+    void separate(const SpatialHash& crowd) {
+        SDL_Point push = {0, 0};
+        int cx = hitbox.x + hitbox.w / 2;
+        int cy = hitbox.y + hitbox.h / 2;
+        crowd.query(hitbox, [&](Sprite* other, const SDL_Rect& other_box) {
+            if (other == this) return;
+            SDL_Rect overlap;
+            if (!SDL_IntersectRect(&hitbox, &other_box, &overlap)) return;
+            int ox = other_box.x + other_box.w / 2;
+            int oy = other_box.y + other_box.h / 2;
+            bool first = other > static_cast<Sprite*>(this);
+            if (overlap.w <= overlap.h) {
+                push.x += ((cx != ox) ? (cx < ox ? -1 : 1) : (first ? -1 : 1)) * (overlap.w + 1) / 2;
+            } else {
+                push.y += ((cy != oy) ? (cy < oy ? -1 : 1) : (first ? -1 : 1)) * (overlap.h + 1) / 2;
+            }
+        });
+        if (push.x == 0 && push.y == 0) return;
+        push.x = std::clamp(push.x, -stats.speed, stats.speed);
+        push.y = std::clamp(push.y, -stats.speed, stats.speed);
+        moveAndCollide(static_cast<float>(push.x), static_cast<float>(push.y));
+    }
+
+    void animate(Uint32 now) {
+        auto& animation = animations[status];
+        int anim_size = static_cast<int>(animation.size());
+        if (anim_size == 0) return;
+
+        frame_index += animation_speed;
+        if (frame_index >= anim_size) frame_index = 0.0f;
+        int new_frame = std::min(static_cast<int>(frame_index), anim_size - 1);
+        if (new_frame != current_frame) {
+            current_frame = new_frame;
+            texture = animation.frames[current_frame];
+            rect.w = animation.sizes[current_frame].x;
+            rect.h = animation.sizes[current_frame].y;
+            recenterRect();
+        }
+
+        if (status == "attack" && current_frame == anim_size - 1) {
+            if (attacking) {
+                attacking = false;
+                can_attack = false;
+                last_attack_time = now;
+            }
+            status = "idle";
+            frame_index = 0.0f;
+        }
+    }
+
+    void moveAndCollide(float dx, float dy) {
+        move(dx, 0);
+        handleCollision('x');
+        move(0, dy);
+        handleCollision('y');
+        recenterRect();
+    }
+
+    void recenterRect() {
+        rect.x = hitbox.x + hitbox.w / 2 - rect.w / 2;
+        rect.y = hitbox.y + hitbox.h / 2 - rect.h / 2;
+    }
+
+    std::string enemy_type;
+    std::string status = "idle";
+    EnemyStats stats;
+    SDL_Rect rect;
+    std::shared_ptr<SDL_Texture> texture;
+    std::unordered_map<std::string, AnimationClip> animations;
+    int current_frame = -1;
+
+    Uint32 last_attack_time = 0;
+    Uint32 attack_cooldown = 600;
+    bool can_attack = true;
+    bool attacking = false;
+    SDL_FPoint knockback{0.0f, 0.0f};
+    Uint32 last_attacked_time = 0;
+    Uint32 invuln_cooldown = 600;
+    bool vulnerable = true;
+};
+
+// Enemy update before and after EnemyStore: the same crowd driven through
+// per-object virtual updates (gathered out of a SpriteGroup with
+// dynamic_pointer_cast every tick, as Level used to) and through the enemy
+// systems on one thread. Update only; nothing is drawn.
+void bench_enemy_store(std::ostream& out, int entities = 10000, int ticks = 200) {
+    CollisionGrid cave = make_cave(256, 256, 1337);
+    const Uint32 tick_ms = 16;
+
+    BenchCrowd crowd(cave, entities, 99);
+
+    SpriteGroup legacy;
+    for (size_t i = 0; i < crowd.slots.size(); ++i) {
+        legacy.add(std::make_shared<LegacyBenchEnemy>(crowd.archetype, crowd.store.transforms[i], &cave));
+    }
+    SpatialHash legacy_crowd;
+    std::vector<LegacyBenchEnemy*> active;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        active.clear();
+        legacy_crowd.clear();
+        for (const auto& sprite : legacy.getSprites()) {
+            if (auto enemy = std::dynamic_pointer_cast<LegacyBenchEnemy>(sprite)) {
+                active.push_back(enemy.get());
+                legacy_crowd.insert(enemy.get(), enemy->getHitbox());
+            }
+        }
+        legacy_crowd.build();
+        for (LegacyBenchEnemy* enemy : active) enemy->update(crowd.player_center, legacy_crowd, tick * tick_ms);
+    }
+    double legacy_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    JobSystem serial(1);
+    EnemyTickContext context;
+    context.grid = &cave;
+    begin = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) {
+        context.now = tick * tick_ms;
+        context.tick = tick + 1;
+        crowd.tick(context, serial);
+    }
+    double store_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    size_t store_bytes = sizeof(Sprite*) + sizeof(size_t*) + sizeof(const EnemyArchetype*) +
+                         sizeof(TransformComponent) + sizeof(MotionComponent) + sizeof(PathComponent) +
+                         sizeof(AnimationComponent) + sizeof(AIComponent) + sizeof(CombatComponent) +
+                         sizeof(RenderComponent) + sizeof(ActivityComponent);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "enemy update, %d enemies chasing on a 256x256 cave x %d ticks\n", entities, ticks);
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %12s %14s %14s\n", "", "ms/tick", "ns/enemy", "bytes/enemy");
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %12.3f %14.1f %14zu\n", "objects", legacy_ms / ticks,
+                  legacy_ms * 1e6 / (static_cast<double>(entities) * ticks), sizeof(LegacyBenchEnemy));
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %12.3f %14.1f %14zu\n", "store", store_ms / ticks,
+                  store_ms * 1e6 / (static_cast<double>(entities) * ticks), store_bytes);
+    out << line;
+    out << "(bytes exclude per-enemy heap: the objects' clip map and strings, the store's route cells)\n";
+}
+
+// Runs the same crowd through the full enemy update (flow field, HPA* routes,
+// knockback, separation) on 1..max_threads threads. Prints a timing row per
+// thread count, and checks that every run leaves every hitbox exactly where
+// the single-threaded run did.
+void bench_jobs(std::ostream& out, unsigned max_threads, int entities = 12000, int ticks = 100) {
+    CollisionGrid cave = make_cave(256, 256, 1337);
+    FlowField field(&cave, static_cast<float>(cave.getColumns() + cave.getRows()));
+    HierarchicalPathfinder pathfinder;
+    pathfinder.build(&cave);
+    const Uint32 tick_ms = 16;
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "enemy update, %d enemies on a 256x256 cave x %d ticks (%u hardware threads)\n",
+                  entities, ticks, std::thread::hardware_concurrency());
+    out << line;
+    std::snprintf(line, sizeof(line), "%-8s %12s %10s %12s\n", "threads", "ms/tick", "speedup", "result");
+    out << line;
+
+    std::vector<SDL_Rect> reference;
+    double reference_ms = 0.0;
+    bool all_identical = true;
+    for (unsigned threads = 1; threads <= max_threads; ++threads) {
+        BenchCrowd crowd(cave, entities, 99);
+        for (size_t i = 0; i < crowd.slots.size(); i += 5) crowd.store.motion[i].knockback = { 7.0f, -5.0f };
+        field.update({ crowd.player_center.x / TILESIZE, crowd.player_center.y / TILESIZE });
+
+        JobSystem jobs(threads);
+        EnemyTickContext context;
+        context.grid = &cave;
+        context.field = &field;
+        context.pathfinder = &pathfinder;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            context.now = tick * tick_ms;
+            context.tick = tick + 1;
+            crowd.tick(context, jobs);
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / ticks;
+
+        std::vector<SDL_Rect> hitboxes;
+        for (const TransformComponent& transform : crowd.store.transforms) hitboxes.push_back(transform.hitbox);
+
+        bool identical = true;
+        if (threads == 1) {
+            reference = std::move(hitboxes);
+            reference_ms = ms;
+        } else {
+            identical = std::equal(hitboxes.begin(), hitboxes.end(), reference.begin(), reference.end(),
+                                   [](const SDL_Rect& a, const SDL_Rect& b) { return SDL_RectEquals(&a, &b); });
+            all_identical = all_identical && identical;
+        }
+
+        std::snprintf(line, sizeof(line), "%-8u %12.3f %9.2fx %12s\n", threads, ms, reference_ms / ms,
+                      threads == 1 ? "reference" : identical ? "identical" : "DIFFERS");
+        out << line;
+    }
+    if (!all_identical) out << "thread count changed the simulation: the read phases are not independent\n";
+}
@@ -5,37 +5,53 @@
 #include "weapon.h"
 #include "enemy.h"
 #include "settings.h"
+#include "texture_cache.h"
+#include "static_layer.h"
+#include "spatial_grid.h"
+#include "depth_sort.h"
+#include "sprite_batch.h"
+#include "profiler.h"
 #include <SDL2/SDL.h>
 #include <iostream>
 #include <vector>
 #include <memory>
 #include <algorithm>
 
+struct CameraStats {
+    int static_draw_calls = 0;
+    int sprite_draw_calls = 0;
+    int sprites_drawn = 0;
+    double cull_ms = 0.0;
+    double sort_ms = 0.0;
+
+    int drawCalls() const { return static_draw_calls + sprite_draw_calls; }
+};
+
 class Camera {
 public:
-    Camera(SDL_Renderer* renderer, SpriteGroup* group)
-        : renderer(renderer), visibleGroup(group) {
+    Camera(SDL_Renderer* renderer, SpatialGrid* grid, const SpriteGroup* flat_group)
+        : renderer(renderer), visibleGrid(grid), batch(renderer) {
 
-        SDL_Surface* floor_surface = IMG_Load("./graphics/tilemap/ground.png");
-        if (!floor_surface) {
-            std::cerr << "Failed to load image 'tilemap.png': " << IMG_GetError() << std::endl;
-            exit(1);
-        }
-
-        texture.reset(SDL_CreateTextureFromSurface(renderer, floor_surface), SDL_DestroyTexture);
+        auto texture = texture_cache.load(renderer, "./graphics/tilemap/ground.png");
         if (!texture) {
-            std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
-            SDL_FreeSurface(floor_surface);
+            std::cerr << "Failed to load floor texture 'ground.png'" << std::endl;
             exit(1);
         }
 
-        floor_rect = {
+        SDL_Point floor_size = texture_size(texture);
+        SDL_Rect floor_rect = {
             0, 0,
-            floor_surface->w,
-            floor_surface->h
+            floor_size.x,
+            floor_size.y
         };
 
-        SDL_FreeSurface(floor_surface);
+        static_layer = std::make_unique<StaticLayer>(renderer, texture, floor_rect, flat_group);
+
+        texture_cache.setDestroyHook([this](SDL_Texture* t) { batch.getAtlas().forget(t); });
+    }
+
+    ~Camera() {
+        texture_cache.setDestroyHook(nullptr);
     }
 
     void centerOn(const SDL_Rect& target) {
@@ -43,44 +59,117 @@ public:
         offset.y = target.y + target.h / 2 - HEIGHT / 2;
     }
 
+    // Follows where the target is drawn, not where it was simulated
+    void centerOn(const Sprite& target, float alpha, Uint32 tick) {
+        SDL_Rect rect = target.getRect();
+        SDL_Point delta = target.renderDelta(alpha, tick);
+        rect.x += delta.x;
+        rect.y += delta.y;
+        centerOn(rect);
+    }
+
     SDL_Point getOffset() const {
         return offset;
     }
 
-    void draw() {
+    // Render targets lose their contents when the device is reset
+    void handleEvent(const SDL_Event& event) {
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            static_layer->rebuildAll();
+        }
+        batch.handleEvent(event);
+    }
+
+    const CameraStats& getStats() const { return stats; }
+
+    // Re-bakes the static layer under `area`, after a flat tile there was removed
+    void rebuildStatic(const SDL_Rect& area) { static_layer->rebuild(area); }
+
+    // `alpha` is how far rendering is between the last two simulation ticks, the
+    // later being `tick`; at 1 everything is drawn where it was simulated.
+    void draw(float alpha = 1.0f, Uint32 tick = 0) {
+        PROFILE_ZONE("camera_draw");
         SDL_Rect view = { offset.x, offset.y, WIDTH, HEIGHT };
+        stats = {};
 
-        // --- Floor ---
-        SDL_Rect shifted_floor = {
-            floor_rect.x - offset.x,
-            floor_rect.y - offset.y,
-            floor_rect.w,
-            floor_rect.h
-        };
-        SDL_RenderCopy(renderer, texture.get(), nullptr, &shifted_floor);
+        // Packs newly seen textures into the atlas, so it runs before anything is drawn
+        batch.begin();
+
+        // --- Floor and flat tiles (baked chunks) ---
+        stats.static_draw_calls = static_layer->draw(view, offset);
 
         // --- Visible Sprites (Sorted by Y for depth) ---
-        std::vector<std::shared_ptr<Sprite>> visible;
-        for (const auto& sprite : visibleGroup->getSprites()) {
-            SDL_Rect rect = sprite->getRect();
-            if (SDL_HasIntersection(&rect, &view)) {
-                visible.push_back(sprite);
-            }
+        Uint64 cull_ticks = 0;
+        Uint64 sort_ticks = 0;
+        Uint64 mark = SDL_GetPerformanceCounter();
+
+        // Static sprites are only re-queried and re-sorted when the view enters new grid cells
+        SDL_Rect static_area = visibleGrid->cellBounds(view);
+        if (!SDL_RectEquals(&static_area, &cached_static_area) ||
+            visibleGrid->staticVersion() != cached_static_version) {
+            static_keys.clear();
+            visibleGrid->queryDepth(static_area, static_keys, GRID_STATIC);
+            cull_ticks += lap(mark);
+            sorter.sort(static_keys);
+            sort_ticks += lap(mark);
+            cached_static_area = static_area;
+            cached_static_version = visibleGrid->staticVersion();
         }
 
-        std::sort(visible.begin(), visible.end(), [](const auto& a, const auto& b) {
-            return (a->getRect().y + a->getRect().h) < (b->getRect().y + b->getRect().h);
-        });
+        dynamic_keys.clear();
+        visibleGrid->queryDepth(view, dynamic_keys, GRID_DYNAMIC);
+        cull_ticks += lap(mark);
+        sorter.sort(dynamic_keys);
+        sort_ticks += lap(mark);
+
+        double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+        stats.cull_ms = cull_ticks * ms_per_tick;
+        stats.sort_ms = sort_ticks * ms_per_tick;
 
-        for (const auto& sprite : visible) {
-            sprite->draw(renderer, offset);  // All Sprite::draw must accept SDL_Point offset
+        // Merge both sorted runs; statics outside the exact view are skipped here
+        size_t s = 0, d = 0;
+        while (s < static_keys.size() || d < dynamic_keys.size()) {
+            const DepthKey* key;
+            if (d == dynamic_keys.size() ||
+                (s < static_keys.size() && static_keys[s].bottom <= dynamic_keys[d].bottom)) {
+                key = &static_keys[s++];
+                if (!SDL_HasIntersection(&visibleGrid->rectAt(key->index), &view)) continue;
+            } else {
+                key = &dynamic_keys[d++];
+            }
+
+            Sprite* sprite = visibleGrid->spriteAt(key->index);
+            SDL_Point delta = sprite->renderDelta(alpha, tick);
+            batch.setDepth(key->bottom);
+            sprite->submit(batch, { offset.x - delta.x, offset.y - delta.y });
+            stats.sprites_drawn++;
         }
+        batch.flush();
+        stats.sprite_draw_calls = batch.drawCalls();
     }
 
 private:
+    // Ticks since `mark`, moving `mark` to now
+    static Uint64 lap(Uint64& mark) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        Uint64 elapsed = now - mark;
+        mark = now;
+        return elapsed;
+    }
+
     SDL_Renderer* renderer = nullptr;
-    SpriteGroup* visibleGroup = nullptr;
-    std::shared_ptr<SDL_Texture> texture;
-    SDL_Rect floor_rect;
+    SpatialGrid* visibleGrid = nullptr;
+
+    SpriteBatch batch;
+
+    // Depth ordering
+    DepthSorter sorter;
+    std::vector<DepthKey> static_keys;
+    std::vector<DepthKey> dynamic_keys;
+    SDL_Rect cached_static_area{0, 0, 0, 0};
+    unsigned int cached_static_version = 0;
+
+    std::unique_ptr<StaticLayer> static_layer;
+    CameraStats stats;
     SDL_Point offset{0, 0};
 };
@@ -0,0 +1,228 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "sprite.h"
+#include "settings.h"
+
+struct SweepHit {
+    bool hit = false;
+    float time = 1.0f;
+    SDL_Point normal{0, 0};
+};
+
+// Tile-aligned collision data for the map.
+//
+// Boundary cells are one byte per tile with no sprite or texture behind them.
+// Obstacle sprites (grass, objects) are indexed by the cell their hitbox sits in:
+// hitboxes that fit in a single cell take that cell's slot, anything larger (wide
+// objects) or sharing a cell goes into a secondary per-cell list. Queries only
+// touch the cells overlapping the rect, so their cost doesn't depend on map size.
+// Everything outside the map is treated as open.
+class CollisionGrid {
+public:
+    CollisionGrid() = default;
+
+    CollisionGrid(int columns, int rows)
+        : columns(columns), rows(rows),
+          cells(static_cast<size_t>(columns) * rows, 0),
+          slots(static_cast<size_t>(columns) * rows) {}
+
+    void setSolid(int col, int row, bool solid = true) {
+        if (!inBounds(col, row)) return;
+        cells[static_cast<size_t>(row) * columns + col] = solid ? 1 : 0;
+        revision++;
+    }
+
+    bool isSolid(int col, int row) const {
+        return inBounds(col, row) && cells[static_cast<size_t>(row) * columns + col] != 0;
+    }
+
+    // Whether anything (boundary or obstacle) touches the tile; used for navigation
+    bool isBlocked(int col, int row) const {
+        if (!inBounds(col, row)) return true;
+        size_t i = index(col, row);
+        return cells[i] || slots[i].sprite || (!oversized.empty() && oversized.count(i));
+    }
+
+    bool inBounds(int col, int row) const {
+        return col >= 0 && row >= 0 && col < columns && row < rows;
+    }
+
+    SDL_Rect cellRect(int col, int row) const {
+        return { col * TILESIZE, row * TILESIZE, TILESIZE, TILESIZE };
+    }
+
+    // Calls visitor(cell_rect) for every solid cell overlapping `area`.
+    template <typename Visitor>
+    void forEachSolid(const SDL_Rect& area, Visitor&& visitor) const {
+        CellSpan span = cellSpan(area);
+
+        for (int row = span.row0; row <= span.row1; ++row) {
+            for (int col = span.col0; col <= span.col1; ++col) {
+                if (cells[index(col, row)]) {
+                    visitor(cellRect(col, row));
+                }
+            }
+        }
+    }
+
+    // Obstacles are static; their hitbox is read once here and cached.
+    void addObstacle(Sprite* sprite) {
+        Obstacle obstacle = { sprite, sprite->getHitbox() };
+        CellSpan span = cellSpan(obstacle.hitbox);
+        if (span.col0 > span.col1 || span.row0 > span.row1) return;
+        revision++;
+
+        if (span.col0 == span.col1 && span.row0 == span.row1) {
+            Obstacle& slot = slots[index(span.col0, span.row0)];
+            if (!slot.sprite) {
+                slot = obstacle;
+                return;
+            }
+        }
+
+        for (int row = span.row0; row <= span.row1; ++row) {
+            for (int col = span.col0; col <= span.col1; ++col) {
+                oversized[index(col, row)].push_back(obstacle);
+            }
+        }
+    }
+
+    void removeObstacle(Sprite* sprite) {
+        Obstacle obstacle = { sprite, sprite->getHitbox() };
+        CellSpan span = cellSpan(obstacle.hitbox);
+        revision++;
+
+        for (int row = span.row0; row <= span.row1; ++row) {
+            for (int col = span.col0; col <= span.col1; ++col) {
+                size_t i = index(col, row);
+                if (slots[i].sprite == sprite) slots[i] = {};
+
+                auto it = oversized.find(i);
+                if (it == oversized.end()) continue;
+                auto& list = it->second;
+                list.erase(std::remove_if(list.begin(), list.end(),
+                    [sprite](const Obstacle& o) { return o.sprite == sprite; }), list.end());
+                if (list.empty()) oversized.erase(it);
+            }
+        }
+    }
+
+    // Calls visitor(hitbox) for every solid cell and obstacle that may overlap `area`.
+    // Oversized obstacles spanning several queried cells can be visited more than once.
+    template <typename Visitor>
+    void forEachBlocker(const SDL_Rect& area, Visitor&& visitor) const {
+        CellSpan span = cellSpan(area);
+
+        for (int row = span.row0; row <= span.row1; ++row) {
+            for (int col = span.col0; col <= span.col1; ++col) {
+                size_t i = index(col, row);
+                if (cells[i]) visitor(cellRect(col, row));
+                if (slots[i].sprite) visitor(slots[i].hitbox);
+
+                if (oversized.empty()) continue;
+                auto it = oversized.find(i);
+                if (it == oversized.end()) continue;
+                for (const Obstacle& obstacle : it->second) visitor(obstacle.hitbox);
+            }
+        }
+    }
+
+    // Moves `box` along `delta` and reports the first blocker it would touch:
+    // `time` is the fraction of `delta` that can be travelled (1 when nothing is
+    // hit) and `normal` is the blocking face. Blockers the box already overlaps
+    // are ignored, so resolving those is left to collide_axis.
+    SweepHit sweep(const SDL_Rect& box, SDL_FPoint delta) const {
+        SweepHit result;
+        if (delta.x == 0.0f && delta.y == 0.0f) return result;
+
+        SDL_Rect moved = {
+            box.x + static_cast<int>(std::floor(delta.x)),
+            box.y + static_cast<int>(std::floor(delta.y)),
+            box.w + 1, box.h + 1
+        };
+        SDL_Rect swept;
+        SDL_UnionRect(&box, &moved, &swept);
+
+        forEachBlocker(swept, [&](const SDL_Rect& blocker) {
+            if (SDL_HasIntersection(&box, &blocker)) return;
+
+            // Per-axis entry/exit times against the blocker's slab
+            float entry_x, exit_x, entry_y, exit_y;
+            if (!slabTimes(box.x, box.w, blocker.x, blocker.w, delta.x, entry_x, exit_x)) return;
+            if (!slabTimes(box.y, box.h, blocker.y, blocker.h, delta.y, entry_y, exit_y)) return;
+
+            float entry = std::max(entry_x, entry_y);
+            float exit = std::min(exit_x, exit_y);
+            if (entry >= exit || entry < 0.0f || entry >= result.time) return;
+
+            result.hit = true;
+            result.time = entry;
+            if (entry_x > entry_y) result.normal = { delta.x > 0.0f ? -1 : 1, 0 };
+            else result.normal = { 0, delta.y > 0.0f ? -1 : 1 };
+        });
+        return result;
+    }
+
+    // Bumped by every change to what blocks; navigation caches compare against it
+    uint32_t getRevision() const { return revision; }
+
+    int getColumns() const { return columns; }
+    int getRows() const { return rows; }
+
+    static int floorDiv(int value, int divisor) {
+        return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+private:
+    // Times (as fractions of `d`) at which [p, p + size) starts and stops
+    // overlapping [q, q + q_size); false if a stationary axis never overlaps.
+    static bool slabTimes(int p, int size, int q, int q_size, float d, float& entry, float& exit) {
+        if (d == 0.0f) {
+            if (p + size <= q || q + q_size <= p) return false;
+            entry = -std::numeric_limits<float>::infinity();
+            exit = std::numeric_limits<float>::infinity();
+            return true;
+        }
+        float near_gap = d > 0.0f ? static_cast<float>(q - (p + size)) : static_cast<float>((q + q_size) - p);
+        float far_gap = d > 0.0f ? static_cast<float>((q + q_size) - p) : static_cast<float>(q - (p + size));
+        entry = near_gap / d;
+        exit = far_gap / d;
+        return true;
+    }
+
+    struct Obstacle {
+        Sprite* sprite = nullptr;
+        SDL_Rect hitbox{0, 0, 0, 0};
+    };
+
+    // Inclusive cell range overlapping a rect, clipped to the map (empty if outside)
+    struct CellSpan {
+        int col0, row0, col1, row1;
+    };
+
+    CellSpan cellSpan(const SDL_Rect& area) const {
+        return {
+            std::max(0, floorDiv(area.x, TILESIZE)),
+            std::max(0, floorDiv(area.y, TILESIZE)),
+            std::min(columns - 1, floorDiv(area.x + area.w - 1, TILESIZE)),
+            std::min(rows - 1, floorDiv(area.y + area.h - 1, TILESIZE))
+        };
+    }
+
+    size_t index(int col, int row) const {
+        return static_cast<size_t>(row) * columns + col;
+    }
+
+    int columns = 0;
+    int rows = 0;
+    uint32_t revision = 0;
+    std::vector<uint8_t> cells;
+    std::vector<Obstacle> slots;
+    std::unordered_map<size_t, std::vector<Obstacle>> oversized;
+};
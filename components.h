@@ -0,0 +1,214 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "animation.h"
+#include "entity.h"
+#include "settings.h"
+#include "sprite.h"
+#include "log.h"
+
+enum class EnemyState : uint8_t {
+    Idle,
+    Move,
+    Attack
+};
+
+const size_t ENEMY_STATE_COUNT = 3;
+
+// Also the name of the state's animation folder
+const char* enemy_state_name(EnemyState state) {
+    switch (state) {
+        case EnemyState::Move:   return "move";
+        case EnemyState::Attack: return "attack";
+        default:                 return "idle";
+    }
+}
+
+// What every enemy of one type shares: base stats and animation clips.
+// Loaded once per type instead of once per enemy.
+struct EnemyArchetype {
+    std::string type;
+    EnemyStats stats;
+    std::array<AnimationClip, ENEMY_STATE_COUNT> animations;  // indexed by EnemyState
+
+    const AnimationClip& clip(EnemyState state) const { return animations[static_cast<size_t>(state)]; }
+};
+
+// Hitbox, and the drawn frame centered on it
+struct TransformComponent {
+    SDL_Rect hitbox{0, 0, 0, 0};
+    SDL_Rect rect{0, 0, 0, 0};
+};
+
+struct MotionComponent {
+    SDL_FPoint knockback{0.0f, 0.0f};  // px per tick
+    MotionHistory history;
+};
+
+// Cached route to the player's tile, replanned only when that tile changes
+struct PathComponent {
+    std::vector<SDL_Point> cells;
+    size_t next = 0;
+    SDL_Point target{-1, -1};
+};
+
+struct AnimationComponent {
+    float frame_index = 0.0f;
+    float speed = 0.15f;
+    int current_frame = -1;
+};
+
+struct AIComponent {
+    EnemyState state = EnemyState::Idle;
+    bool attacking = false;
+    bool can_attack = true;
+    SDL_FPoint direction{0.0f, 0.0f};  // toward the player
+    float distance = 0.0f;
+    Uint32 last_attack_time = 0;
+    Uint32 attack_cooldown = 600;
+};
+
+struct CombatComponent {
+    int health = 0;
+    bool alive = true;
+    bool vulnerable = true;
+    Uint32 last_attacked_time = 0;
+    Uint32 invuln_cooldown = 600;
+};
+
+// When the AI scheduler last ran this enemy, and how many ticks that covered
+struct ActivityComponent {
+    Uint32 last_tick = 0;
+    Uint32 elapsed = 1;
+};
+
+struct RenderComponent {
+    SDL_Texture* texture = nullptr;  // owned by the archetype's clips
+};
+
+// Dense, slot-aligned component arrays for every live enemy: slot i of each
+// array belongs to the same enemy, so systems walk them front to back. Removal
+// moves the last enemy into the freed slot and patches its owner's index.
+//
+// Only the per-tick enemy update runs on the arrays. The camera, the combat
+// grid and the player's attacks still reach enemies through their Enemy
+// sprite handles, which read the same slots.
+class EnemyStore {
+public:
+    explicit EnemyStore(SDL_Renderer* renderer) : renderer(renderer) {}
+
+    EnemyStore(const EnemyStore&) = delete;
+    EnemyStore& operator=(const EnemyStore&) = delete;
+
+    const EnemyArchetype* archetype(const std::string& type) {
+        auto it = archetype_cache.find(type);
+        if (it != archetype_cache.end()) return it->second.get();
+
+        auto stats = monster_data.find(type);
+        if (stats == monster_data.end()) {
+            std::cerr << "Error, Unknown enemy type: " << type << std::endl;
+            exit(1);
+        }
+
+        auto loaded = std::make_unique<EnemyArchetype>();
+        loaded->type = type;
+        loaded->stats = stats->second;
+
+        std::string basePath = "./graphics/monsters/" + type + "/";
+        for (size_t state = 0; state < ENEMY_STATE_COUNT; ++state) {
+            loaded->animations[state] = load_animation_clip(renderer,
+                basePath + enemy_state_name(static_cast<EnemyState>(state)));
+        }
+
+        const EnemyArchetype* result = loaded.get();
+        archetype_cache[type] = std::move(loaded);
+        return result;
+    }
+
+    // `slot_ref` is where the owner keeps its slot index; it is rewritten when the enemy moves.
+    size_t add(Sprite* owner, size_t* slot_ref, const EnemyArchetype* type, const TransformComponent& transform) {
+        owners.push_back(owner);
+        slot_refs.push_back(slot_ref);
+        archetypes.push_back(type);
+        transforms.push_back(transform);
+        motion.emplace_back();
+        paths.emplace_back();
+        animation.emplace_back();
+        ai.emplace_back();
+        combat.emplace_back();
+        combat.back().health = type->stats.health;
+        render.emplace_back();
+        activity.emplace_back();
+        live++;
+        return owners.size() - 1;
+    }
+
+    void remove(size_t slot) {
+        if (combat[slot].alive) live--;
+        size_t last = owners.size() - 1;
+        if (slot != last) *slot_refs[last] = slot;
+
+        swapRemove(owners, slot);
+        swapRemove(slot_refs, slot);
+        swapRemove(archetypes, slot);
+        swapRemove(transforms, slot);
+        swapRemove(motion, slot);
+        swapRemove(paths, slot);
+        swapRemove(animation, slot);
+        swapRemove(ai, slot);
+        swapRemove(combat, slot);
+        swapRemove(render, slot);
+        swapRemove(activity, slot);
+    }
+
+    size_t size() const { return owners.size(); }
+    // Enemies not yet killed; dead ones stay in the store until their owner removes them
+    size_t liveCount() const { return live; }
+
+    void kill(size_t slot) {
+        if (!combat[slot].alive) return;
+        combat[slot].alive = false;
+        live--;
+    }
+
+    void triggerAttack(size_t slot, Uint32 now) {
+        AIComponent& state = ai[slot];
+        if (damage_player && state.can_attack) {
+            damage_player(archetypes[slot]->stats.attack_damage);
+            state.can_attack = false;
+            state.last_attack_time = now;
+        }
+    }
+
+    std::vector<Sprite*> owners;
+    std::vector<const EnemyArchetype*> archetypes;
+    std::vector<TransformComponent> transforms;
+    std::vector<MotionComponent> motion;
+    std::vector<PathComponent> paths;
+    std::vector<AnimationComponent> animation;
+    std::vector<AIComponent> ai;
+    std::vector<CombatComponent> combat;
+    std::vector<RenderComponent> render;
+    std::vector<ActivityComponent> activity;
+
+    std::function<void(int)> damage_player;
+
+private:
+    template <typename T>
+    static void swapRemove(std::vector<T>& values, size_t slot) {
+        if (slot + 1 != values.size()) values[slot] = std::move(values.back());
+        values.pop_back();
+    }
+
+    SDL_Renderer* renderer = nullptr;
+    size_t live = 0;
+    std::vector<size_t*> slot_refs;
+    std::unordered_map<std::string, std::unique_ptr<EnemyArchetype>> archetype_cache;
+};
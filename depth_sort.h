@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "settings.h"
+
+// Plain sort key for depth ordering: the bottom edge of a sprite's rect and the
+// index of the sprite in whatever container produced the key.
+struct DepthKey {
+    int bottom;
+    int index;
+};
+
+inline bool depth_less(const DepthKey& a, const DepthKey& b) {
+    return a.bottom < b.bottom || (a.bottom == b.bottom && a.index < b.index);
+}
+
+// Counting sort by tile row followed by an insertion pass. Sprites in different
+// rows land in order after the first pass, so the insertion pass only has to fix
+// up neighbours within a row and stays close to linear.
+class DepthSorter {
+public:
+    void sort(std::vector<DepthKey>& keys) {
+        if (keys.size() < 2) return;
+
+        if (keys.size() > 32) {
+            int min_bottom = keys[0].bottom;
+            int max_bottom = keys[0].bottom;
+            for (const auto& key : keys) {
+                min_bottom = std::min(min_bottom, key.bottom);
+                max_bottom = std::max(max_bottom, key.bottom);
+            }
+
+            size_t row_count = static_cast<size_t>((max_bottom - min_bottom) / TILESIZE) + 1;
+            counts.assign(row_count + 1, 0);
+            for (const auto& key : keys) {
+                counts[(key.bottom - min_bottom) / TILESIZE + 1]++;
+            }
+            for (size_t i = 1; i < counts.size(); ++i) {
+                counts[i] += counts[i - 1];
+            }
+
+            scratch.resize(keys.size());
+            for (const auto& key : keys) {
+                scratch[counts[(key.bottom - min_bottom) / TILESIZE]++] = key;
+            }
+            keys.swap(scratch);
+        }
+
+        for (size_t i = 1; i < keys.size(); ++i) {
+            DepthKey key = keys[i];
+            size_t j = i;
+            while (j > 0 && depth_less(key, keys[j - 1])) {
+                keys[j] = keys[j - 1];
+                --j;
+            }
+            keys[j] = key;
+        }
+    }
+
+private:
+    std::vector<size_t> counts;
+    std::vector<DepthKey> scratch;
+};
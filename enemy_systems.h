@@ -0,0 +1,320 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "components.h"
+#include "collision_grid.h"
+#include "spatial_hash.h"
+#include "hierarchical_pathfinder.h"
+#include "flow_field.h"
+#include "job_system.h"
+#include "entity.h"
+#include "settings.h"
+#include "log.h"
+
+// Per-tick enemy behaviour over the slots the AiScheduler picked (ascending,
+// live enemies only), run by enemy_update() in four phases:
+//
+//   read (parallel)  sense the player, steer along the flow field
+//   serial           replan routes the flow field doesn't cover
+//   read (parallel)  propose movement, animate
+//   commit (serial)  move against the collision grid, land attacks
+//
+// Read-phase steps only write the enemy's own slot and its EnemyIntent, so
+// they can run on any thread in any order. Everything that touches shared
+// state (the route planner's scratch, collision counters, the player) happens
+// in a serial phase in slot order, which keeps results identical to a
+// single-threaded run; --bench-jobs checks that for every thread count.
+
+// Slots per job; below this the read phases run inline
+const size_t ENEMY_JOB_GRAIN = 256;
+
+// Entrance nodes per search; the notice radius keeps real chases far below this
+const int PATH_MAX_EXPANSIONS = 1024;
+
+// What the read phases decided for one enemy, applied by the commit phase
+struct EnemyIntent {
+    bool needs_route = false;   // chasing outside the flow field
+    bool walk = false;          // step along ai.direction
+    SDL_Point push{0, 0};       // separation from the crowd
+    bool attack_lands = false;  // attack clip reached its last frame
+};
+
+// Shared, read-only inputs for one tick of enemy_update()
+struct EnemyTickContext {
+    SDL_Point player_center{0, 0};
+    Uint32 now = 0;
+    Uint32 tick = 0;  // Level::getTick(), for render interpolation
+    const FlowField* field = nullptr;
+    HierarchicalPathfinder* pathfinder = nullptr;
+    const CollisionGrid* grid = nullptr;
+    const SpatialHash* crowd = nullptr;  // every awake enemy as of the start of the tick
+};
+
+// Path cost, in tiles, the shared flow field has to cover: the largest notice
+// radius plus a tile, since enemies measure it from their center, not their cell.
+float chase_range_tiles() {
+    int radius = 0;
+    for (const auto& entry : monster_data) radius = std::max(radius, entry.second.notice_radius);
+    return static_cast<float>(radius) / TILESIZE + 1.0f;
+}
+
+SDL_Point hitbox_cell(const SDL_Rect& hitbox) {
+    return {
+        CollisionGrid::floorDiv(hitbox.x + hitbox.w / 2, TILESIZE),
+        CollisionGrid::floorDiv(hitbox.y + hitbox.h / 2, TILESIZE)
+    };
+}
+
+// Aims at the center of `cell`
+void steer(AIComponent& ai, SDL_Point from, SDL_Point cell) {
+    float dx = cell.x * TILESIZE + TILESIZE / 2.0f - from.x;
+    float dy = cell.y * TILESIZE + TILESIZE / 2.0f - from.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length > 0.0f) ai.direction = { dx / length, dy / length };
+}
+
+// Invulnerability wears off; senses the player and picks idle / move / attack
+void enemy_sense(EnemyStore& store, size_t i, SDL_Point player_center, Uint32 now) {
+    CombatComponent& combat = store.combat[i];
+    if (!combat.vulnerable && now - combat.last_attacked_time >= combat.invuln_cooldown)
+        combat.vulnerable = true;
+
+    const SDL_Rect& rect = store.transforms[i].rect;
+    const EnemyStats& stats = store.archetypes[i]->stats;
+    AIComponent& ai = store.ai[i];
+
+    SDL_FPoint diff = {
+        player_center.x - (rect.x + rect.w / 2.0f),
+        player_center.y - (rect.y + rect.h / 2.0f)
+    };
+    ai.distance = std::sqrt(diff.x * diff.x + diff.y * diff.y);
+    ai.direction = {0.0f, 0.0f};
+    if (ai.distance > 0.0f) {
+        ai.direction = { diff.x / ai.distance, diff.y / ai.distance };
+    }
+
+    ai.can_attack = (now - ai.last_attack_time >= ai.attack_cooldown);
+
+    if (ai.distance <= stats.attack_radius) {
+        if (ai.can_attack && !ai.attacking) {
+            ai.state = EnemyState::Attack;
+            ai.attacking = true;
+            store.animation[i].frame_index = 0.0f;
+        }
+    } else if (ai.distance <= stats.notice_radius) {
+        ai.state = EnemyState::Move;
+    } else {
+        ai.state = EnemyState::Idle;
+    }
+}
+
+// Points a chasing enemy at the next cell toward the player's tile off the
+// shared flow field. False when the field doesn't reach it (a long detour).
+bool enemy_follow_field(EnemyStore& store, size_t i, const FlowField& field, SDL_Point goal) {
+    AIComponent& ai = store.ai[i];
+    if (ai.state != EnemyState::Move) return true;
+
+    const SDL_Rect& hitbox = store.transforms[i].hitbox;
+    SDL_Point cell = hitbox_cell(hitbox);
+    if (cell.x == goal.x && cell.y == goal.y) return true;  // same tile: head straight at them
+
+    SDL_Point waypoint;
+    if (!field.next(cell, waypoint)) return false;
+    steer(ai, { hitbox.x + hitbox.w / 2, hitbox.y + hitbox.h / 2 }, waypoint);
+    return true;
+}
+
+// Follows a cached route instead, replanned when the player changes tile or
+// the enemy gets pushed off it. Shares the planner's scratch: serial only.
+void enemy_follow_route(EnemyStore& store, size_t i, HierarchicalPathfinder& pathfinder, SDL_Point goal) {
+    const SDL_Rect& hitbox = store.transforms[i].hitbox;
+    SDL_Point cell = hitbox_cell(hitbox);
+
+    PathComponent& path = store.paths[i];
+    while (path.next < path.cells.size() &&
+           path.cells[path.next].x == cell.x && path.cells[path.next].y == cell.y) {
+        path.next++;
+    }
+
+    bool off_route = path.next < path.cells.size() &&
+                     (std::abs(path.cells[path.next].x - cell.x) > 1 ||
+                      std::abs(path.cells[path.next].y - cell.y) > 1);
+    if (path.target.x != goal.x || path.target.y != goal.y || off_route) {
+        path.target = goal;
+        path.next = 0;
+        if (!pathfinder.findPath(cell, goal, path.cells, PATH_MAX_EXPANSIONS)) path.cells.clear();
+    }
+
+    // No route: keep heading straight at them
+    if (path.next >= path.cells.size()) return;
+    steer(store.ai[i], { hitbox.x + hitbox.w / 2, hitbox.y + hitbox.h / 2 }, path.cells[path.next]);
+}
+
+// Axis-separated move resolved against the collision grid
+void move_and_collide(SDL_Rect& hitbox, const CollisionGrid* grid, float dx, float dy) {
+    hitbox.x += static_cast<int>(dx);
+    if (grid) collide_axis(hitbox, *grid, 'x');
+    hitbox.y += static_cast<int>(dy);
+    if (grid) collide_axis(hitbox, *grid, 'y');
+}
+
+// Pushes enemy `i` out of the enemies it overlaps along the shallower axis.
+// Each of a pair moves half the overlap, capped at its speed so crowds settle
+// over a few ticks instead of jittering.
+SDL_Point separation_push(const EnemyStore& store, size_t i, const SpatialHash& crowd) {
+    const SDL_Rect& hitbox = store.transforms[i].hitbox;
+    Sprite* self = store.owners[i];
+    SDL_Point push = {0, 0};
+    int cx = hitbox.x + hitbox.w / 2;
+    int cy = hitbox.y + hitbox.h / 2;
+
+    crowd.query(hitbox, [&](Sprite* other, const SDL_Rect& other_box) {
+        if (other == self) return;
+        SDL_Rect overlap;
+        if (!SDL_IntersectRect(&hitbox, &other_box, &overlap)) return;
+
+        int ox = other_box.x + other_box.w / 2;
+        int oy = other_box.y + other_box.h / 2;
+        // Stacked exactly on top of each other: split by address so the pair still parts
+        bool first = other > self;
+
+        if (overlap.w <= overlap.h) {
+            int side = (cx != ox) ? (cx < ox ? -1 : 1) : (first ? -1 : 1);
+            push.x += side * (overlap.w + 1) / 2;
+        } else {
+            int side = (cy != oy) ? (cy < oy ? -1 : 1) : (first ? -1 : 1);
+            push.y += side * (overlap.h + 1) / 2;
+        }
+    });
+
+    int speed = store.archetypes[i]->stats.speed;
+    push.x = std::clamp(push.x, -speed, speed);
+    push.y = std::clamp(push.y, -speed, speed);
+    return push;
+}
+
+// Knockback slides, otherwise chase the player; either way separate from the
+// crowd. Measured from where the enemy starts the tick.
+void enemy_propose(const EnemyStore& store, size_t i, const SpatialHash* crowd, EnemyIntent& intent) {
+    const MotionComponent& motion = store.motion[i];
+    bool knocked_back = motion.knockback.x != 0.0f || motion.knockback.y != 0.0f;
+    intent.walk = !knocked_back && store.ai[i].state == EnemyState::Move;
+    if (crowd) intent.push = separation_push(store, i, *crowd);
+}
+
+// Advances the current clip by however many ticks the scheduler skipped; the
+// attack lands on its last frame (applied in the commit phase)
+void enemy_animate(EnemyStore& store, size_t i, EnemyIntent& intent) {
+    AIComponent& ai = store.ai[i];
+    AnimationComponent& anim = store.animation[i];
+    const AnimationClip& animation = store.archetypes[i]->clip(ai.state);
+    int anim_size = static_cast<int>(animation.size());
+    if (anim_size == 0) return;
+
+    anim.frame_index += anim.speed * store.activity[i].elapsed;
+    if (anim.frame_index >= anim_size) {
+        anim.frame_index = ai.state == EnemyState::Attack ? anim_size - 1.0f : std::fmod(anim.frame_index, anim_size);
+    }
+
+    int new_frame = static_cast<int>(anim.frame_index);
+    if (new_frame >= anim_size) new_frame = anim_size - 1;
+
+    if (new_frame != anim.current_frame) {
+        anim.current_frame = new_frame;
+        SDL_Rect& rect = store.transforms[i].rect;
+        const SDL_Rect& hitbox = store.transforms[i].hitbox;
+        store.render[i].texture = animation.frames[new_frame].get();
+        rect.w = animation.sizes[new_frame].x;
+        rect.h = animation.sizes[new_frame].y;
+        rect.x = hitbox.x + hitbox.w / 2 - rect.w / 2;
+        rect.y = hitbox.y + hitbox.h / 2 - rect.h / 2;
+    }
+
+    if (ai.state == EnemyState::Attack && anim.current_frame == anim_size - 1) {
+        if (ai.attacking) {
+            intent.attack_lands = true;
+            ai.attacking = false;
+        }
+        ai.state = EnemyState::Idle;
+        anim.frame_index = 0.0f;
+    }
+}
+
+// Applies one enemy's intent: moves it through the collision grid and lands its attack
+void enemy_commit(EnemyStore& store, size_t i, const EnemyIntent& intent, const EnemyTickContext& context) {
+    const CollisionGrid* grid = context.grid;
+    Uint32 now = context.now;
+    TransformComponent& transform = store.transforms[i];
+    MotionComponent& motion = store.motion[i];
+    AIComponent& ai = store.ai[i];
+    SDL_Rect& hitbox = transform.hitbox;
+
+    if (motion.knockback.x != 0.0f || motion.knockback.y != 0.0f) {
+        motion.history.store(hitbox, context.tick);
+        SDL_Point normal = sweep_move(hitbox, grid, motion.knockback);
+
+        if (normal.x) motion.knockback.x = 0.0f;
+        if (normal.y) motion.knockback.y = 0.0f;
+        motion.knockback.x *= KNOCKBACK_DECAY;
+        motion.knockback.y *= KNOCKBACK_DECAY;
+        if (std::abs(motion.knockback.x) < 1.0f && std::abs(motion.knockback.y) < 1.0f)
+            motion.knockback = {0.0f, 0.0f};
+    } else if (intent.walk) {
+        float speed = static_cast<float>(store.archetypes[i]->stats.speed);
+        motion.history.store(hitbox, context.tick);
+        move_and_collide(hitbox, grid, ai.direction.x * speed, ai.direction.y * speed);
+    }
+
+    if (intent.push.x != 0 || intent.push.y != 0) {
+        motion.history.store(hitbox, context.tick);
+        move_and_collide(hitbox, grid, static_cast<float>(intent.push.x), static_cast<float>(intent.push.y));
+    }
+
+    transform.rect.x = hitbox.x + hitbox.w / 2 - transform.rect.w / 2;
+    transform.rect.y = hitbox.y + hitbox.h / 2 - transform.rect.h / 2;
+
+    if (intent.attack_lands) {
+        LOG_DEBUG(Combat, "%s attacked with %s", store.archetypes[i]->type.c_str(),
+                  store.archetypes[i]->stats.attack_type.c_str());
+        store.triggerAttack(i, now);  // once, at the end of the clip
+        ai.can_attack = false;
+        ai.last_attack_time = now;
+    }
+}
+
+// One tick for every scheduled enemy. `intents` is scratch indexed by slot.
+void enemy_update(EnemyStore& store, const std::vector<size_t>& slots, const EnemyTickContext& context,
+                  JobSystem& jobs, std::vector<EnemyIntent>& intents) {
+    if (intents.size() < store.size()) intents.resize(store.size());
+    SDL_Point goal = {
+        CollisionGrid::floorDiv(context.player_center.x, TILESIZE),
+        CollisionGrid::floorDiv(context.player_center.y, TILESIZE)
+    };
+
+    jobs.parallelFor(slots.size(), ENEMY_JOB_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            size_t i = slots[k];
+            intents[i] = {};
+            enemy_sense(store, i, context.player_center, context.now);
+            if (context.field) intents[i].needs_route = !enemy_follow_field(store, i, *context.field, goal);
+        }
+    });
+
+    if (context.pathfinder) {
+        for (size_t i : slots) {
+            if (intents[i].needs_route) enemy_follow_route(store, i, *context.pathfinder, goal);
+        }
+    }
+
+    jobs.parallelFor(slots.size(), ENEMY_JOB_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            size_t i = slots[k];
+            enemy_propose(store, i, context.crowd, intents[i]);
+            enemy_animate(store, i, intents[i]);
+        }
+    });
+
+    for (size_t i : slots) enemy_commit(store, i, intents[i], context);
+}
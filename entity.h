@@ -1,65 +1,158 @@
 #pragma once
+#include <cmath>
 #include "sprite.h"
 #include "support.h"
+#include "collision_grid.h"
+#include "profiler.h"
+#include "log.h"
 
-class Entity : public Sprite {
+// Performance-counter ticks spent in collision resolution, read and reset by the
+// benchmark. Only touched from the main thread (collision runs in serial phases).
+inline Uint64 collision_ticks = 0;
+
+// Charges the enclosing scope to collision_ticks. Pair with PROFILE_ZONE("collision")
+// so the overlay and the benchmark see the same work.
+class CollisionTimer {
 public:
+    CollisionTimer() : start(SDL_GetPerformanceCounter()) {}
+    ~CollisionTimer() { collision_ticks += SDL_GetPerformanceCounter() - start; }
 
-    virtual ~Entity() = default;
+    CollisionTimer(const CollisionTimer&) = delete;
+    CollisionTimer& operator=(const CollisionTimer&) = delete;
 
-    void move(float dx, float dy) {
-        hitbox.x += static_cast<int>(dx);
-        hitbox.y += static_cast<int>(dy);
+private:
+    Uint64 start;
+};
+
+// Where a moving hitbox was at the start of the tick it last moved in, for render
+// interpolation. Ticks are Level::getTick() values.
+struct MotionHistory {
+    SDL_Point previous{0, 0};
+    Uint32 tick = ~0u;  // never matches before the first tick
+
+    // Only the first call in a tick records anything
+    void store(const SDL_Rect& hitbox, Uint32 current_tick) {
+        if (tick == current_tick) return;
+        previous = { hitbox.x, hitbox.y };
+        tick = current_tick;
     }
 
-    bool checkCollision(const SDL_Rect& a, const SDL_Rect& b) {
-        return SDL_HasIntersection(&a, &b);
+    // Hitboxes that didn't move during `current_tick` are drawn where they are
+    SDL_Point delta(const SDL_Rect& hitbox, Uint32 current_tick, float alpha) const {
+        if (tick != current_tick) return {0, 0};
+        float lag = 1.0f - alpha;
+        return {
+            static_cast<int>(std::lround((previous.x - hitbox.x) * lag)),
+            static_cast<int>(std::lround((previous.y - hitbox.y) * lag))
+        };
     }
+};
 
-    void handleCollision(char axis) {
-        for (const auto& sprite : obstacleGroup->getSprites()) {
-            if (checkCollision(hitbox, sprite->getHitbox())) {
-                std::cout << "[Collision Detected] Axis: " << axis
-                          << " | Player Hitbox: " << hitbox.x << "," << hitbox.y
-                          << " | Obstacle Hitbox: " << sprite->getHitbox().x << "," << sprite->getHitbox().y << "\n";
-
-                resolveCollision(sprite->getHitbox(), axis);
-            }
+// Pushes `hitbox` back out of `obstacle` along one axis
+void resolve_collision(SDL_Rect& hitbox, const SDL_Rect& obstacle, char axis) {
+    if (axis == 'x') {
+        int overlap;
+        if (hitbox.x < obstacle.x) {
+            overlap = (hitbox.x + hitbox.w) - obstacle.x;
+            hitbox.x -= overlap;
+        } else {
+            overlap = (obstacle.x + obstacle.w) - hitbox.x;
+            hitbox.x += overlap;
         }
+        LOG_TRACE(Collision, "Resolved X: new hitbox.x = %d, overlap = %d", hitbox.x, overlap);
     }
 
-
-    void resolveCollision(const SDL_Rect& obstacle, char axis) {
-        if (axis == 'x') {
-            int overlap;
-            if (hitbox.x < obstacle.x) {
-                overlap = (hitbox.x + hitbox.w) - obstacle.x;
-                hitbox.x -= overlap;
-            } else {
-                overlap = (obstacle.x + obstacle.w) - hitbox.x;
-                hitbox.x += overlap;
-            }
-            std::cout << "[Resolved X] New hitbox.x = " << hitbox.x << ", overlap = " << overlap << "\n";
+    if (axis == 'y') {
+        int overlap;
+        if (hitbox.y < obstacle.y) {
+            overlap = (hitbox.y + hitbox.h) - obstacle.y;
+            hitbox.y -= overlap;
+        } else {
+            overlap = (obstacle.y + obstacle.h) - hitbox.y;
+            hitbox.y += overlap;
         }
+        LOG_TRACE(Collision, "Resolved Y: new hitbox.y = %d, overlap = %d", hitbox.y, overlap);
+    }
+}
+
+// Resolves `hitbox` against every blocker it overlaps; the grid broadphase only
+// looks at the cells under the hitbox.
+void collide_axis(SDL_Rect& hitbox, const CollisionGrid& grid, char axis) {
+    PROFILE_ZONE("collision");
+    CollisionTimer timer;
+
+    grid.forEachBlocker(hitbox, [&](const SDL_Rect& blocker) {
+        if (SDL_HasIntersection(&hitbox, &blocker)) {
+            LOG_DEBUG(Collision, "Axis: %c | Hitbox: %d,%d | Obstacle Hitbox: %d,%d",
+                      axis, hitbox.x, hitbox.y, blocker.x, blocker.y);
 
-        if (axis == 'y') {
-            int overlap;
-            if (hitbox.y < obstacle.y) {
-                overlap = (hitbox.y + hitbox.h) - obstacle.y;
-                hitbox.y -= overlap;
-            } else {
-                overlap = (obstacle.y + obstacle.h) - hitbox.y;
-                hitbox.y += overlap;
-            }
-            std::cout << "[Resolved Y] New hitbox.y = " << hitbox.y << ", overlap = " << overlap << "\n";
+            resolve_collision(hitbox, blocker, axis);
         }
+    });
+}
+
+// Moves `hitbox` by `delta` without tunnelling through anything in the grid,
+// sliding along whatever it hits. Returns the last face hit, {0, 0} if none.
+SDL_Point sweep_move(SDL_Rect& hitbox, const CollisionGrid* grid, SDL_FPoint delta) {
+    PROFILE_ZONE("collision");
+    CollisionTimer timer;
+    SDL_Point normal = {0, 0};
+    if (!grid) {
+        hitbox.x += static_cast<int>(delta.x);
+        hitbox.y += static_cast<int>(delta.y);
+        return normal;
     }
 
+    for (int pass = 0; pass < 2; ++pass) {
+        SweepHit hit = grid->sweep(hitbox, delta);
+        hitbox.x += static_cast<int>(delta.x * hit.time);
+        hitbox.y += static_cast<int>(delta.y * hit.time);
+        if (!hit.hit) break;
 
+        // Keep what's left of the move along the face that was hit
+        normal = hit.normal;
+        float remaining = 1.0f - hit.time;
+        delta = {
+            hit.normal.x ? 0.0f : delta.x * remaining,
+            hit.normal.y ? 0.0f : delta.y * remaining
+        };
+    }
+    return normal;
+}
+
+class Entity : public Sprite {
+public:
+
+    virtual ~Entity() = default;
+
+    SDL_Point renderDelta(float alpha, Uint32 tick) const override {
+        return history.delta(hitbox, tick, alpha);
+    }
+
+    // Records where the entity starts tick `tick`; called by the level before anything can move it
+    void beginTick(Uint32 tick) {
+        history.store(hitbox, tick);
+    }
+
+    void move(float dx, float dy) {
+        hitbox.x += static_cast<int>(dx);
+        hitbox.y += static_cast<int>(dy);
+    }
+
+    SDL_Point sweepMove(SDL_FPoint delta) {
+        return sweep_move(hitbox, collisionGrid, delta);
+    }
+
+    void handleCollision(char axis) {
+        if (collisionGrid) collide_axis(hitbox, *collisionGrid, axis);
+    }
 
     SDL_Rect hitbox;
     SDL_FPoint normalizedDirection{0, 0};
-    SpriteGroup* obstacleGroup = nullptr;
+    const CollisionGrid* collisionGrid = nullptr;
     float frame_index = 0.0f;
     float animation_speed = 0.15f;
+
+private:
+    MotionHistory history;
 };
@@ -0,0 +1,133 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "collision_grid.h"
+#include "pathfinder.h"
+
+// Dijkstra map toward one seed tile, shared by every enemy chasing it.
+//
+// Each reached cell stores which neighbour is one step closer to the seed, so
+// steering is a single lookup however many enemies follow the field. Costs and
+// corner rules match GridPathfinder. The search stops at `range` tiles of path
+// cost, and only reruns when the seed moves to another tile or the grid changes.
+class FlowField {
+public:
+    explicit FlowField(const CollisionGrid* grid = nullptr, float range = 8.0f) : grid(grid), range(range) {}
+
+    void setGrid(const CollisionGrid* new_grid) {
+        grid = new_grid;
+        valid = false;
+    }
+
+    void setRange(float tiles) {
+        range = tiles;
+        valid = false;
+    }
+
+    // Rebuilds if the seed changed tile or the grid changed; true when it rebuilt.
+    bool update(SDL_Point seed_cell) {
+        if (!grid) return false;
+        if (valid && seed_cell.x == seed.x && seed_cell.y == seed.y && grid->getRevision() == grid_revision)
+            return false;
+
+        seed = seed_cell;
+        grid_revision = grid->getRevision();
+        valid = true;
+        rebuild();
+        return true;
+    }
+
+    // The neighbour of `cell` one step closer to the seed; false at the seed or outside the field.
+    bool next(SDL_Point cell, SDL_Point& out) const {
+        if (!valid || !grid->inBounds(cell.x, cell.y)) return false;
+        size_t i = static_cast<size_t>(cell.y) * grid->getColumns() + cell.x;
+        if (stamp[i] != build_id || step[i] < 0) return false;
+        out = { cell.x + DX[step[i]], cell.y + DY[step[i]] };
+        return true;
+    }
+
+    // Cells reached by the last rebuild
+    int lastReached() const { return reached; }
+
+private:
+    static constexpr int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    static constexpr int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    static constexpr int8_t OPPOSITE[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+    struct OpenNode {
+        float cost;
+        int index;
+    };
+
+    static bool heap_greater(const OpenNode& a, const OpenNode& b) { return a.cost > b.cost; }
+
+    void rebuild() {
+        reached = 0;
+        if (!grid->inBounds(seed.x, seed.y)) return;
+
+        int columns = grid->getColumns();
+        size_t cells = static_cast<size_t>(columns) * grid->getRows();
+        if (stamp.size() != cells) {
+            stamp.assign(cells, 0);
+            cost.assign(cells, 0.0f);
+            step.assign(cells, -1);
+            build_id = 0;
+        }
+        if (++build_id == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            build_id = 1;
+        }
+
+        int seed_index = seed.y * columns + seed.x;
+        stamp[seed_index] = build_id;
+        cost[seed_index] = 0.0f;
+        step[seed_index] = -1;
+        open.clear();
+        open.push_back({ 0.0f, seed_index });
+
+        // Walk outward from the seed; a cell's step points back at the neighbour it was reached from
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), heap_greater);
+            OpenNode node = open.back();
+            open.pop_back();
+            if (node.cost > cost[node.index]) continue;  // stale duplicate
+            reached++;
+
+            int col = node.index % columns;
+            int row = node.index / columns;
+            for (int d = 0; d < 8; ++d) {
+                int nc = col + DX[d];
+                int nr = row + DY[d];
+                if (grid->isBlocked(nc, nr)) continue;
+                if (d >= 4 && (grid->isBlocked(col + DX[d], row) || grid->isBlocked(col, row + DY[d]))) continue;
+
+                float next_cost = node.cost + (d >= 4 ? PATH_DIAGONAL_COST : 1.0f);
+                if (next_cost > range) continue;
+
+                int next = nr * columns + nc;
+                if (stamp[next] == build_id && next_cost >= cost[next]) continue;
+
+                stamp[next] = build_id;
+                cost[next] = next_cost;
+                step[next] = OPPOSITE[d];
+                open.push_back({ next_cost, next });
+                std::push_heap(open.begin(), open.end(), heap_greater);
+            }
+        }
+    }
+
+    const CollisionGrid* grid = nullptr;
+    float range;
+    SDL_Point seed{-1, -1};
+    uint32_t grid_revision = 0;
+    bool valid = false;
+    uint32_t build_id = 0;
+    int reached = 0;
+
+    std::vector<uint32_t> stamp;  // build that last reached the cell
+    std::vector<float> cost;
+    std::vector<int8_t> step;     // index into DX/DY, -1 at the seed
+    std::vector<OpenNode> open;
+};
@@ -0,0 +1,403 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "collision_grid.h"
+#include "pathfinder.h"
+
+const int PATH_CLUSTER_SIZE = 16;  // tiles per cluster side
+
+// HPA*: the map is cut into square clusters and every open stretch of a
+// cluster border becomes an entrance (one pair of nodes facing each other
+// across the border, two for long stretches). Nodes in the same cluster are
+// linked with their exact in-cluster path cost, so a query is a short A* over
+// entrances followed by bounded A* inside each cluster it crosses.
+//
+// Paths are near-optimal rather than optimal. Changing a cell only rebuilds the
+// borders of its cluster and the links of that cluster and its neighbours.
+class HierarchicalPathfinder {
+public:
+    explicit HierarchicalPathfinder(int cluster_size = PATH_CLUSTER_SIZE) : cluster_size(cluster_size) {}
+
+    // Call once the grid holds every boundary and obstacle.
+    void build(const CollisionGrid* new_grid) {
+        grid = new_grid;
+        refiner.setGrid(grid);
+        nodes.clear();
+        free_nodes.clear();
+        cluster_cols = grid ? (grid->getColumns() + cluster_size - 1) / cluster_size : 0;
+        cluster_rows = grid ? (grid->getRows() + cluster_size - 1) / cluster_size : 0;
+        borders.assign(static_cast<size_t>(cluster_cols) * cluster_rows * 2, {});
+
+        for (int cluster = 0; cluster < clusterCount(); ++cluster) {
+            buildBorder(cluster, EAST);
+            buildBorder(cluster, SOUTH);
+        }
+        for (int cluster = 0; cluster < clusterCount(); ++cluster) linkCluster(cluster);
+    }
+
+    // Call after what blocks inside `area` (in pixels) changed, e.g. a patch of grass cut down.
+    void refresh(const SDL_Rect& area) {
+        if (!grid || clusterCount() == 0) return;
+        int span = cluster_size * TILESIZE;
+        int col0 = std::max(0, CollisionGrid::floorDiv(area.x, span));
+        int row0 = std::max(0, CollisionGrid::floorDiv(area.y, span));
+        int col1 = std::min(cluster_cols - 1, CollisionGrid::floorDiv(area.x + area.w - 1, span));
+        int row1 = std::min(cluster_rows - 1, CollisionGrid::floorDiv(area.y + area.h - 1, span));
+        if (col0 > col1 || row0 > row1) return;
+
+        // Every border of a touched cluster, then links wherever those entrances ended up
+        std::vector<int> relink;
+        for (int cy = row0; cy <= row1; ++cy) {
+            for (int cx = col0; cx <= col1; ++cx) {
+                int cluster = cy * cluster_cols + cx;
+                buildBorder(cluster, EAST);
+                buildBorder(cluster, SOUTH);
+                if (cx > 0) buildBorder(cluster - 1, EAST);
+                if (cy > 0) buildBorder(cluster - cluster_cols, SOUTH);
+
+                relink.push_back(cluster);
+                if (cx > 0) relink.push_back(cluster - 1);
+                if (cy > 0) relink.push_back(cluster - cluster_cols);
+                if (cx + 1 < cluster_cols) relink.push_back(cluster + 1);
+                if (cy + 1 < cluster_rows) relink.push_back(cluster + cluster_cols);
+            }
+        }
+        std::sort(relink.begin(), relink.end());
+        relink.erase(std::unique(relink.begin(), relink.end()), relink.end());
+        for (int cluster : relink) linkCluster(cluster);
+    }
+
+    // Same contract as GridPathfinder::findPath; `max_expansions` caps the entrance search.
+    bool findPath(SDL_Point start, SDL_Point goal, std::vector<SDL_Point>& out, int max_expansions = 1 << 30) {
+        out.clear();
+        expanded = 0;
+        if (!grid || !grid->inBounds(start.x, start.y) || !grid->inBounds(goal.x, goal.y)) return false;
+        if (start.x == goal.x && start.y == goal.y) return true;
+
+        int start_cluster = clusterOf(start);
+        int goal_cluster = clusterOf(goal);
+        if (start_cluster == goal_cluster &&
+            refiner.findPathWithin(start, goal, clusterArea(start_cluster), out)) {
+            return true;
+        }
+        out.clear();
+
+        // Temporary endpoint nodes, linked into their clusters for this query only
+        int start_node = allocNode(start, start_cluster);
+        int goal_node = allocNode(goal, goal_cluster);
+        const std::vector<float>& from_start = clusterCosts(start_cluster, start);
+        forEachClusterNode(start_cluster, [&](int node) {
+            float cost = from_start[localIndex(start_cluster, nodes[node].cell)];
+            if (cost < UNREACHED) nodes[start_node].edges.push_back({ node, cost });
+        });
+        goal_links.clear();
+        const std::vector<float>& from_goal = clusterCosts(goal_cluster, goal);
+        forEachClusterNode(goal_cluster, [&](int node) {
+            float cost = from_goal[localIndex(goal_cluster, nodes[node].cell)];
+            if (cost < UNREACHED) {
+                nodes[node].edges.push_back({ goal_node, cost });
+                goal_links.push_back(node);
+            }
+        });
+
+        bool found = searchAbstract(start_node, goal_node, max_expansions);
+        for (size_t i = 1; found && i < route.size(); ++i) {
+            const Node& from = nodes[route[i - 1]];
+            const Node& to = nodes[route[i]];
+            if (from.cell.x == to.cell.x && from.cell.y == to.cell.y) continue;
+            if (from.cluster != to.cluster) {
+                out.push_back(to.cell);  // across a border: neighbouring cells
+            } else {
+                found = refiner.findPathWithin(from.cell, to.cell, clusterArea(from.cluster), out);
+            }
+        }
+
+        for (int node : goal_links) nodes[node].edges.pop_back();
+        releaseNode(start_node);
+        releaseNode(goal_node);
+        if (!found) out.clear();
+        return found;
+    }
+
+    // Entrance nodes expanded by the last query
+    int lastExpanded() const { return expanded; }
+
+    size_t entranceCount() const { return nodes.size() - free_nodes.size(); }
+
+private:
+    enum Side { EAST = 0, SOUTH = 1 };
+
+    static constexpr float UNREACHED = std::numeric_limits<float>::max();
+
+    struct Edge {
+        int to;
+        float cost;
+        bool crossing = false;  // between the two nodes of an entrance
+    };
+
+    struct Node {
+        SDL_Point cell{0, 0};
+        int cluster = -1;
+        std::vector<Edge> edges;
+    };
+
+    struct OpenNode {
+        float f;
+        int node;
+    };
+
+    static bool heap_greater(const OpenNode& a, const OpenNode& b) { return a.f > b.f; }
+
+    int clusterCount() const { return cluster_cols * cluster_rows; }
+
+    int clusterOf(SDL_Point cell) const {
+        return (cell.y / cluster_size) * cluster_cols + cell.x / cluster_size;
+    }
+
+    // In cells, clipped to the map
+    SDL_Rect clusterArea(int cluster) const {
+        int x = (cluster % cluster_cols) * cluster_size;
+        int y = (cluster / cluster_cols) * cluster_size;
+        return { x, y, std::min(cluster_size, grid->getColumns() - x), std::min(cluster_size, grid->getRows() - y) };
+    }
+
+    size_t localIndex(int cluster, SDL_Point cell) const {
+        SDL_Rect area = clusterArea(cluster);
+        return static_cast<size_t>(cell.y - area.y) * cluster_size + (cell.x - area.x);
+    }
+
+    int allocNode(SDL_Point cell, int cluster) {
+        int id;
+        if (!free_nodes.empty()) {
+            id = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            id = static_cast<int>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[id].cell = cell;
+        nodes[id].cluster = cluster;
+        nodes[id].edges.clear();
+        return id;
+    }
+
+    void releaseNode(int id) {
+        nodes[id].cluster = -1;
+        nodes[id].edges.clear();
+        free_nodes.push_back(id);
+    }
+
+    // Replaces the entrances on one border of `cluster` (its east or south edge)
+    void buildBorder(int cluster, Side side) {
+        std::vector<int>& entrances = borders[cluster * 2 + side];
+        for (int node : entrances) releaseNode(node);
+        entrances.clear();
+
+        int cx = cluster % cluster_cols;
+        int cy = cluster / cluster_cols;
+        if (side == EAST && cx + 1 >= cluster_cols) return;
+        if (side == SOUTH && cy + 1 >= cluster_rows) return;
+
+        SDL_Rect area = clusterArea(cluster);
+        int neighbour = side == EAST ? cluster + 1 : cluster + cluster_cols;
+        int length = side == EAST ? area.h : area.w;
+
+        // Cell `i` along the border on this side, and the one facing it
+        auto inner = [&](int i) -> SDL_Point {
+            return side == EAST ? SDL_Point{ area.x + area.w - 1, area.y + i } : SDL_Point{ area.x + i, area.y + area.h - 1 };
+        };
+        auto outer = [&](int i) -> SDL_Point {
+            SDL_Point cell = inner(i);
+            return side == EAST ? SDL_Point{ cell.x + 1, cell.y } : SDL_Point{ cell.x, cell.y + 1 };
+        };
+        auto open = [&](int i) {
+            SDL_Point a = inner(i), b = outer(i);
+            return !grid->isBlocked(a.x, a.y) && !grid->isBlocked(b.x, b.y);
+        };
+        auto addEntrance = [&](int i) {
+            int a = allocNode(inner(i), cluster);
+            int b = allocNode(outer(i), neighbour);
+            nodes[a].edges.push_back({ b, 1.0f, true });
+            nodes[b].edges.push_back({ a, 1.0f, true });
+            entrances.push_back(a);
+            entrances.push_back(b);
+        };
+
+        for (int i = 0; i < length;) {
+            if (!open(i)) {
+                ++i;
+                continue;
+            }
+            int first = i;
+            while (i < length && open(i)) ++i;
+            int last = i - 1;
+
+            // Long openings get one entrance at each end so paths needn't funnel through the middle
+            if (last - first + 1 >= 6) {
+                addEntrance(first);
+                addEntrance(last);
+            } else {
+                addEntrance((first + last) / 2);
+            }
+        }
+    }
+
+    // Calls visitor(node) for every entrance node inside `cluster`
+    template <typename Visitor>
+    void forEachClusterNode(int cluster, Visitor&& visitor) const {
+        int cx = cluster % cluster_cols;
+        int cy = cluster / cluster_cols;
+        const std::vector<int>* lists[4] = {
+            &borders[cluster * 2 + EAST],
+            &borders[cluster * 2 + SOUTH],
+            cx > 0 ? &borders[(cluster - 1) * 2 + EAST] : nullptr,
+            cy > 0 ? &borders[(cluster - cluster_cols) * 2 + SOUTH] : nullptr
+        };
+        for (const std::vector<int>* list : lists) {
+            if (!list) continue;
+            for (int node : *list) {
+                if (nodes[node].cluster == cluster) visitor(node);
+            }
+        }
+    }
+
+    // Drops the in-cluster links of every node in `cluster` and recomputes them
+    void linkCluster(int cluster) {
+        members.clear();
+        forEachClusterNode(cluster, [&](int node) { members.push_back(node); });
+
+        for (int node : members) {
+            auto& edges = nodes[node].edges;
+            edges.erase(std::remove_if(edges.begin(), edges.end(),
+                [](const Edge& edge) { return !edge.crossing; }), edges.end());
+        }
+        for (int node : members) {
+            const std::vector<float>& costs = clusterCosts(cluster, nodes[node].cell);
+            for (int other : members) {
+                if (other == node) continue;
+                float cost = costs[localIndex(cluster, nodes[other].cell)];
+                if (cost < UNREACHED) nodes[node].edges.push_back({ other, cost });
+            }
+        }
+    }
+
+    // Dijkstra from `source` that never leaves `cluster`; costs indexed by localIndex
+    const std::vector<float>& clusterCosts(int cluster, SDL_Point source) {
+        static const int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+        static const int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+        SDL_Rect area = clusterArea(cluster);
+        local_cost.assign(static_cast<size_t>(cluster_size) * cluster_size, UNREACHED);
+        local_cost[localIndex(cluster, source)] = 0.0f;
+        local_open.clear();
+        local_open.push_back({ 0.0f, static_cast<int>(localIndex(cluster, source)) });
+
+        while (!local_open.empty()) {
+            std::pop_heap(local_open.begin(), local_open.end(), heap_greater);
+            OpenNode current = local_open.back();
+            local_open.pop_back();
+            if (current.f > local_cost[current.node]) continue;
+
+            int col = area.x + current.node % cluster_size;
+            int row = area.y + current.node / cluster_size;
+            for (int d = 0; d < 8; ++d) {
+                int nc = col + DX[d];
+                int nr = row + DY[d];
+                if (nc < area.x || nr < area.y || nc >= area.x + area.w || nr >= area.y + area.h) continue;
+                if (grid->isBlocked(nc, nr)) continue;
+                if (d >= 4 && (grid->isBlocked(col + DX[d], row) || grid->isBlocked(col, row + DY[d]))) continue;
+
+                float cost = current.f + (d >= 4 ? PATH_DIAGONAL_COST : 1.0f);
+                int next = (nr - area.y) * cluster_size + (nc - area.x);
+                if (cost >= local_cost[next]) continue;
+                local_cost[next] = cost;
+                local_open.push_back({ cost, next });
+                std::push_heap(local_open.begin(), local_open.end(), heap_greater);
+            }
+        }
+        return local_cost;
+    }
+
+    // A* over the entrance graph; fills `route` with node ids from start to goal
+    bool searchAbstract(int start, int goal, int max_expansions) {
+        route.clear();
+        if (stamp.size() < nodes.size()) {
+            stamp.resize(nodes.size(), 0);
+            closed.resize(nodes.size(), 0);
+            cost_so_far.resize(nodes.size(), 0.0f);
+            parent.resize(nodes.size(), -1);
+        }
+        if (++search_id == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            search_id = 1;
+        }
+
+        SDL_Point target = nodes[goal].cell;
+        auto heuristic = [&](int node) {
+            return octile_distance(target.x - nodes[node].cell.x, target.y - nodes[node].cell.y);
+        };
+
+        stamp[start] = search_id;
+        cost_so_far[start] = 0.0f;
+        parent[start] = -1;
+        open.clear();
+        open.push_back({ heuristic(start), start });
+
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), heap_greater);
+            int node = open.back().node;
+            open.pop_back();
+            if (closed[node] == search_id) continue;
+            closed[node] = search_id;
+
+            if (node == goal) {
+                for (int at = goal; at != -1; at = parent[at]) route.push_back(at);
+                std::reverse(route.begin(), route.end());
+                return true;
+            }
+            if (++expanded > max_expansions) return false;
+
+            for (const Edge& edge : nodes[node].edges) {
+                if (closed[edge.to] == search_id) continue;
+                float cost = cost_so_far[node] + edge.cost;
+                if (stamp[edge.to] == search_id && cost >= cost_so_far[edge.to]) continue;
+
+                stamp[edge.to] = search_id;
+                cost_so_far[edge.to] = cost;
+                parent[edge.to] = node;
+                open.push_back({ cost + heuristic(edge.to), edge.to });
+                std::push_heap(open.begin(), open.end(), heap_greater);
+            }
+        }
+        return false;
+    }
+
+    const CollisionGrid* grid = nullptr;
+    int cluster_size;
+    int cluster_cols = 0;
+    int cluster_rows = 0;
+    int expanded = 0;
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    std::vector<std::vector<int>> borders;  // [cluster * 2 + side]: both nodes of each entrance
+
+    GridPathfinder refiner;
+
+    // Scratch, reused across queries and rebuilds
+    std::vector<int> members;
+    std::vector<int> goal_links;
+    std::vector<int> route;
+    std::vector<float> local_cost;
+    std::vector<OpenNode> local_open;
+    uint32_t search_id = 0;
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> closed;
+    std::vector<float> cost_so_far;
+    std::vector<int> parent;
+    std::vector<OpenNode> open;
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const unsigned JOB_MAX_THREADS = 256;  // upper bound accepted from the command line
+
+// Work-stealing thread pool for data-parallel loops over the simulation.
+//
+// parallelFor() cuts the range into chunks and deals them round-robin onto one
+// deque per thread. Each thread works the back of its own deque, and an idle
+// one steals from the front of the others. The calling thread joins in, and
+// the call returns only once every chunk has run. Chunks must write disjoint
+// data; then the result does not depend on which thread ran what.
+class JobSystem {
+public:
+    // `threads` includes the calling thread; 0 means one per hardware thread
+    explicit JobSystem(unsigned threads = 0) { start(threads); }
+    ~JobSystem() { stop(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void setThreads(unsigned threads) {
+        stop();
+        start(threads);
+    }
+
+    unsigned threadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // Calls fn(begin, end) over [0, count) in chunks of at most `grain`
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        grain = std::max<size_t>(grain, 1);
+        if (workers.empty() || count <= grain) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        std::function<void(size_t, size_t)> body = std::ref(fn);
+        job = &body;
+        size_t chunks = (count + grain - 1) / grain;
+        pending.store(chunks);
+        for (size_t c = 0; c < chunks; ++c) {
+            Queue& queue = *queues[c % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back({ c * grain, std::min(count, (c + 1) * grain) });
+        }
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            generation++;
+        }
+        wake.notify_all();
+
+        runTasks(0);
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [this]() { return pending.load() == 0; });
+        job = nullptr;
+    }
+
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> tasks;
+    };
+
+    void start(unsigned threads) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+        workers.clear();
+        queues.clear();
+        stopping = false;
+    }
+
+    // Own deque from the back, then steal from the front of the others
+    bool popTask(size_t self, Range& out) {
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                out = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); ++k) {
+            Queue& victim = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runTasks(size_t self) {
+        Range range;
+        while (popTask(self, range)) {
+            (*job)(range.begin, range.end);
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(done_mutex);
+                done.notify_all();
+            }
+        }
+    }
+
+    void workerLoop(size_t self) {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            runTasks(self);
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;  // [0] belongs to the calling thread
+    std::vector<std::thread> workers;
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    std::atomic<size_t> pending{0};
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    std::mutex done_mutex;
+    std::condition_variable done;
+};
@@ -6,17 +6,123 @@
 #include "support.h"
 #include "weapon.h"
 #include "enemy.h"
+#include "enemy_systems.h"
+#include "ai_scheduler.h"
+#include "registry.h"
+#include "texture_cache.h"
+#include "spatial_grid.h"
+#include "spatial_hash.h"
+#include "profiler.h"
+#include "log.h"
 #include <SDL2/SDL.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include <random>
 class Level {
 public:
 
-    Level(SDL_Renderer* renderer) : renderer(renderer) {
+    Level(SDL_Renderer* renderer) : renderer(renderer), enemy_store(renderer) {
+        enemy_store.damage_player = [this](int damage) {
+            LOG_DEBUG(Combat, "player hit for %d damage", damage);
+            if (registry.player) {
+                registry.player->takeDamage(damage);
+            }
+        };
         create_map();
+        build_visible_grid();
+        build_combat_grid();
+        for (const auto& sprite : obstacle_sprites.getSprites()) {
+            collision_grid.addObstacle(sprite.get());
+        }
+        pathfinder.build(&collision_grid);
+        flow_field.setGrid(&collision_grid);
+        flow_field.setRange(chase_range_tiles());
+        wake_extent = ai_wake_extent();
+        preload_weapon_textures();
     };
 
+    // Index every Y-sorted sprite for view culling; static ones never move again.
+    // Movers go in first, so the pass over the group only adds what's left as static.
+    void build_visible_grid() {
+        SDL_Rect world = { 0, 0, map_columns * TILESIZE, map_rows * TILESIZE };
+        visible_grid = SpatialGrid(world);
+        if (registry.player) visible_grid.insert(registry.player.get(), GRID_DYNAMIC);
+        for (const auto& enemy : registry.enemies) {
+            visible_grid.insert(enemy.get(), GRID_DYNAMIC);
+        }
+        for (const auto& sprite : visible_sprites.getSprites()) {
+            visible_grid.insert(sprite.get(), GRID_STATIC);
+        }
+    }
+
+    // Hitboxes of everything combat can touch, tagged by role for queryRect()
+    void build_combat_grid() {
+        SDL_Rect world = { 0, 0, map_columns * TILESIZE, map_rows * TILESIZE };
+        combat_grid = SpatialGrid(world, TILESIZE * 4, GridBounds::Hitbox);
+        for (const auto& enemy : registry.enemies) {
+            combat_grid.insert(enemy.get(), GRID_ENEMY);
+        }
+        for (const auto& sprite : attackable_sprites.getSprites()) {
+            combat_grid.insert(sprite.get(), GRID_DESTRUCTIBLE);
+        }
+        if (registry.player) combat_grid.insert(registry.player.get(), GRID_PLAYER);
+    }
+
+    // Appends every combat sprite in a `mask` category whose hitbox overlaps `area`.
+    // Sprites tagged GRID_ENEMY are always Enemy, GRID_DESTRUCTIBLE are grass
+    // Tiles, GRID_PLAYER is the player.
+    void queryRect(const SDL_Rect& area, unsigned int mask, std::vector<Sprite*>& out) {
+        combat_grid.query(area, out, mask);
+    }
+
+    // Keep a handle to every directional weapon sprite so attacking never hits the disk
+    void preload_weapon_textures() {
+        for (const auto& name : weapons) {
+            for (const char* dir : {"up", "down", "left", "right"}) {
+                auto texture = texture_cache.load(renderer, weapon_graphics[name] + dir + ".png");
+                if (texture) preloaded_textures.push_back(std::move(texture));
+            }
+        }
+    }
+
+    std::shared_ptr<Enemy> create_enemy(SDL_Point pos, const std::string& type) {
+        return createEnemy(enemy_store, pos, {&visible_sprites, &attackable_sprites}, type, &registry);
+    }
+
+    // Benchmark helper: scatters `count` extra enemies over open tiles around the
+    // player, with the same layout every run.
+    int spawn_enemies(int count) {
+        static const char* types[] = {"bamboo", "spirit", "raccoon", "squid"};
+        std::mt19937 rng(1337);
+        int radius = 8 + static_cast<int>(std::sqrt(static_cast<float>(count)));
+        std::uniform_int_distribution<int> offset(-radius, radius);
+
+        SDL_Point center = registry.player->getCenter();
+        int center_col = center.x / TILESIZE;
+        int center_row = center.y / TILESIZE;
+
+        int spawned = 0;
+        for (int attempt = 0; spawned < count && attempt < count * 20; ++attempt) {
+            int col = center_col + offset(rng);
+            int row = center_row + offset(rng);
+            if (!collision_grid.inBounds(col, row)) continue;
+
+            SDL_Rect cell = collision_grid.cellRect(col, row);
+            bool blocked = false;
+            collision_grid.forEachBlocker(cell, [&](const SDL_Rect& blocker) {
+                if (SDL_HasIntersection(&blocker, &cell)) blocked = true;
+            });
+            if (blocked) continue;
+
+            auto enemy = create_enemy({cell.x, cell.y}, types[spawned % 4]);
+            visible_grid.insert(enemy.get(), GRID_DYNAMIC);
+            combat_grid.insert(enemy.get(), GRID_ENEMY);
+            spawned++;
+        }
+        return spawned;
+    }
+
     void create_map() {
     std::unordered_map<std::string, std::vector<std::vector<std::string>>> layouts = {
         { "boundary", import_csv_layout("map/map_FloorBlocks.csv") },
@@ -30,6 +136,15 @@ public:
         { "objects", import_folder("graphics/objects") }
     };
 
+    for (const auto& [style, layout] : layouts) {
+        map_rows = std::max(map_rows, static_cast<int>(layout.size()));
+        for (const auto& row : layout) {
+            map_columns = std::max(map_columns, static_cast<int>(row.size()));
+        }
+    }
+
+    collision_grid = CollisionGrid(map_columns, map_rows);
+
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> grass_dist(0, graphics["grass"].size() - 1);
@@ -45,22 +160,23 @@ public:
                 int y = i * TILESIZE;
 
                 if (style == "boundary") {
-                    createTile(renderer, {x, y}, {&obstacle_sprites}, "invisible");
+                    collision_grid.setSolid(j, i);
                 } else if (style == "grass") {
-                    createTile(renderer, {x, y}, {&visible_sprites, &obstacle_sprites, &attackable_sprites},
-                               "grass", graphics["grass"][grass_dist(gen)]);
+                    add_drawable_tile(createTile(renderer, {x, y}, {&obstacle_sprites, &attackable_sprites},
+                                                 "grass", graphics["grass"][grass_dist(gen)], &registry));
                 } else if (style == "objects") {
                     int obj_idx = stoi(cell);
-                    createTile(renderer, {x, y}, {&obstacle_sprites, &visible_sprites},
-                               "objects", graphics["objects"][obj_idx]);
+                    add_drawable_tile(createTile(renderer, {x, y}, {&obstacle_sprites},
+                                                 "objects", graphics["objects"][obj_idx], &registry));
                 } else if (style == "entities") {
                     int obj_idx = stoi(cell);
                     if (obj_idx == 394) {
 						std::cout << "new player created" << std::endl;
-                        player = createPlayer(renderer, {x, y}, {&visible_sprites}, &obstacle_sprites,
+                        createPlayer(renderer, {x, y}, {&visible_sprites}, &collision_grid,
                                               [this]() { this->create_attack(); },
                                               nullptr,
-                                              [this]() { this->create_magic(); });
+                                              [this]() { this->create_magic(); },
+                                              &registry);
                     }
                 }
             }
@@ -88,116 +204,207 @@ public:
                     type = "bamboo";
                     break;
             }
-            auto enemy = createEnemy(
-                renderer,
-                {x, y},
-                {&visible_sprites, &attackable_sprites},
-                &obstacle_sprites,
-                [this](int damage) {
-                    std::cout << "[lambda] Called with damage: " << damage << "\n";
-    				if (player) {
-        				std::cout << "[lambda] Player address: " << player.get() << "\n";
-        				player->takeDamage(damage);
-    				}
-                },
-                type
-            );
+            create_enemy({x, y}, type);
         }
     }
 }
-    void create_attack() {
-        if (player->currentWeapon) {
-            visible_sprites.remove(player->currentWeapon);
-            attack_sprites.remove(player->currentWeapon);
-            player->currentWeapon.reset();
+    // Tiles no taller than a grid cell never need Y-sorting against entities,
+    // so they are baked into the camera's static layer instead.
+    void add_drawable_tile(const std::shared_ptr<Tile>& tile) {
+        if (tile->getRect().h > TILESIZE) {
+            visible_sprites.add(tile);
+        } else {
+            static_sprites.add(tile);
         }
+    }
+
+    void create_attack() {
+        destroy_attack();
 
-        player->currentWeapon = createWeapon(
+        registry.player->currentWeapon = createWeapon(
             renderer,
-            player,
+            registry.player,
             {&visible_sprites, &attack_sprites},
-            weapon_graphics[weapons[player->weapon_index]]
+            weapon_graphics[weapons[registry.player->weapon_index]],
+            &registry
         );
+        visible_grid.insert(registry.player->currentWeapon.get());
+    }
+
+    void destroy_attack() {
+        if (!registry.player->currentWeapon) return;
+
+        visible_grid.remove(registry.player->currentWeapon.get());
+        visible_sprites.remove(registry.player->currentWeapon);
+        attack_sprites.remove(registry.player->currentWeapon);
+        registry.weapons.erase(registry.player->currentWeapon.get());
+        registry.player->currentWeapon.reset();
     }
     void create_magic() {
-        std::cout << "create_magic successfully called." << std::endl;
+        LOG_DEBUG(Combat, "create_magic called");
     }
 
 void player_attack_logic() {
-    if (!player->attacking || !player->currentWeapon) return;
+    PROFILE_ZONE("player_attack");
+    if (!registry.player->attacking || !registry.player->currentWeapon) return;
 
-    SDL_Rect weapon_rect = player->currentWeapon->getHitbox();
+    SDL_Rect weapon_rect = registry.player->currentWeapon->getHitbox();
 
-    for (const auto& sprite : attackable_sprites.getSprites()) {
-        auto enemy = std::dynamic_pointer_cast<Enemy>(sprite);
-        if (!enemy || !enemy->isAlive() || !enemy->isVulnerable()) continue;
+    hits.clear();
+    queryRect(weapon_rect, GRID_ENEMY, hits);
+    for (Sprite* sprite : hits) {
+        Enemy* enemy = static_cast<Enemy*>(sprite);
+        if (!enemy->isAlive() || !enemy->isVulnerable()) continue;
 
-        SDL_Rect enemy_hitbox = enemy->getHitbox();
+        enemy->takeDamage(registry.player->stats.attack, getTime());
 
-        if (SDL_HasIntersection(&weapon_rect, &enemy_hitbox)) {
-            enemy->takeDamage(player->stats.attack);
-
-            // Knockback direction
-SDL_FPoint dir = enemy->getPlayerDistanceAndDirection(player->getCenter()).second;
-dir.x *= -1;
-dir.y *= -1;
-enemy->applyKnockback(dir);
+        // Knockback direction
+        SDL_FPoint dir = enemy->getPlayerDistanceAndDirection(registry.player->getCenter()).second;
+        dir.x *= -1;
+        dir.y *= -1;
+        enemy->applyKnockback(dir);
 
+        LOG_DEBUG(Combat, "weapon hit: %s took %d damage and was knocked back",
+                  enemy->getType().c_str(), registry.player->stats.attack);
+    }
 
-            std::cout << "[Weapon Hit] " << enemy->getType()
-                      << " took " << player->stats.attack << " damage and was knocked back.\n";
-        }
+    // Any weapon hit cuts grass; only tiles are tagged GRID_DESTRUCTIBLE
+    hits.clear();
+    queryRect(weapon_rect, GRID_DESTRUCTIBLE, hits);
+    for (Sprite* sprite : hits) {
+        remove_obstacle(std::static_pointer_cast<Tile>(attackable_sprites.find(sprite)));
     }
 }
 
 
 
 void enemy_attack_logic() {
-    SDL_Rect player_hitbox = player->getHitbox();
+    PROFILE_ZONE("enemy_attack");
+    SDL_Rect player_hitbox = registry.player->getHitbox();
+
+    hits.clear();
+    queryRect(player_hitbox, GRID_ENEMY, hits);
+    for (Sprite* sprite : hits) {
+        Enemy* enemy = static_cast<Enemy*>(sprite);
+        if (enemy->isAttacking()) {
+            enemy->triggerAttack(getTime());  // this should call the callback which runs registry.player->takeDamage
+        }
+    }
+}
 
-    for (const auto& sprite : attackable_sprites.getSprites()) {
-        auto enemy = std::dynamic_pointer_cast<Enemy>(sprite);
-        if (enemy && enemy->isAttacking()) {
-            SDL_Rect enemy_hitbox = enemy->getHitbox();
 
-            if (SDL_HasIntersection(&player_hitbox, &enemy_hitbox)) {
-                enemy->triggerAttack();  // this should call the callback which runs player->takeDamage
-            }
+// Grids and the registry forget dead enemies now; the groups drop them at the end of the tick
+void remove_dead_enemies() {
+    for (size_t i = 0; i < registry.enemies.size();) {
+        std::shared_ptr<Enemy> enemy = registry.enemies[i];
+        if (enemy->isAlive()) {
+            ++i;
+            continue;
         }
+
+        visible_grid.remove(enemy.get());
+        combat_grid.remove(enemy.get());
+        visible_sprites.remove(enemy);
+        attackable_sprites.remove(enemy);
+        registry.enemies.erase(enemy.get());  // moves the last enemy into slot i
     }
 }
 
+// Takes a destructible obstacle (cut grass) out of the level. Navigation only
+// rebuilds the clusters around it, and the flow field rebuilds on its next
+// update since the collision grid's revision changed. A flat tile's area is
+// re-baked by the static-change hook once the removal is flushed. Takes the
+// tile by value so it outlives its removal from the registry and the groups.
+void remove_obstacle(std::shared_ptr<Tile> tile) {
+    LOG_DEBUG(Combat, "%s cut at %d,%d", tile->getType().c_str(), tile->getRect().x, tile->getRect().y);
+    collision_grid.removeObstacle(tile.get());
+    pathfinder.refresh(tile->getHitbox());
+    static_changes.push_back(tile->getRect());
+    visible_grid.remove(tile.get());
+    combat_grid.remove(tile.get());
+    visible_sprites.remove(tile);
+    static_sprites.remove(tile);
+    obstacle_sprites.remove(tile);
+    attackable_sprites.remove(tile);
+    registry.tiles.erase(tile.get());
+}
 
+// One fixed simulation tick
 void update() {
-    if (player->currentWeapon && !player->attacking) {
-        visible_sprites.remove(player->currentWeapon);
-        attack_sprites.remove(player->currentWeapon);
-        player->currentWeapon.reset();
+    PROFILE_ZONE("level_update");
+    tick++;
+    registry.player->beginTick(tick);
+    registry.player->setClock(getTime());
+    if (registry.player->currentWeapon && !registry.player->attacking) {
+        destroy_attack();
     }
 
-    obstacle_sprites.update();
-    visible_sprites.update();
-    attack_sprites.update();
+    // Tiles never change on their own and enemies run through the enemy systems
+    registry.player->update();
+    for (const auto& weapon : registry.weapons) {
+        weapon->update();
+    }
 
+    combat_grid.update(registry.player.get());
     player_attack_logic();
 	enemy_attack_logic();
-    attackable_sprites.update();
-	for (auto& group : {&attackable_sprites, &visible_sprites}) {
-    for (auto sprite : group->getSprites()) {
-        auto enemy = std::dynamic_pointer_cast<Enemy>(sprite);
-        if (enemy && !enemy->isAlive()) {
-            group->remove(sprite);
+    remove_dead_enemies();
+
+    SDL_Point player_center = registry.player->getCenter();
+    flow_field.update({ CollisionGrid::floorDiv(player_center.x, TILESIZE),
+                        CollisionGrid::floorDiv(player_center.y, TILESIZE) });
+
+    // Only enemies around the player are looked at; the rest sleep where they are
+    SDL_Rect wake_area = { player_center.x - wake_extent.x, player_center.y - wake_extent.y,
+                           wake_extent.x * 2, wake_extent.y * 2 };
+    hits.clear();
+    queryRect(wake_area, GRID_ENEMY, hits);
+    awake_slots.clear();
+    for (Sprite* sprite : hits) awake_slots.push_back(static_cast<Enemy*>(sprite)->getSlot());
+    const std::vector<size_t>& slots = ai_scheduler.schedule(enemy_store, awake_slots, player_center, tick);
+
+    // Awake enemy positions as of this point in the tick, for enemy-vs-enemy separation
+    enemy_hash.clear();
+    for (size_t i : awake_slots) {
+        if (enemy_store.combat[i].alive) {
+            enemy_hash.insert(enemy_store.owners[i], enemy_store.transforms[i].hitbox);
         }
     }
-}
+    enemy_hash.build();
+
+    {
+        PROFILE_ZONE("enemy_update");
+        EnemyTickContext context;
+        context.player_center = player_center;
+        context.now = getTime();
+        context.tick = tick;
+        context.field = &flow_field;
+        context.pathfinder = &pathfinder;
+        context.grid = &collision_grid;
+        context.crowd = &enemy_hash;
+        enemy_update(enemy_store, slots, context, jobs, enemy_intents);
+    }
 
-    SDL_Point player_center = player->getCenter();
+    for (size_t i : slots) {
+        visible_grid.update(enemy_store.owners[i]);
+        combat_grid.update(enemy_store.owners[i]);
+    }
 
-    for (const auto& sprite : visible_sprites.getSprites()) {
-        auto enemy = std::dynamic_pointer_cast<Enemy>(sprite);
-        if (enemy) {
-            enemy->update(player_center);
-        }
+    visible_grid.update(registry.player.get());
+    flush_removals();
+
+    // Removed flat tiles are out of their group now, so re-baking drops them
+    for (const SDL_Rect& area : static_changes) {
+        if (static_change_hook) static_change_hook(area);
+    }
+    static_changes.clear();
+}
+
+// Applies this tick's SpriteGroup removals; sprites nothing else holds are destroyed here
+void flush_removals() {
+    for (SpriteGroup* group : {&visible_sprites, &static_sprites, &obstacle_sprites,
+                               &attackable_sprites, &attack_sprites}) {
+        group->flush();
     }
 }
 
@@ -211,15 +418,47 @@ void update() {
     // Getters and Setters
     const SpriteGroup& getVisibleSprites() const { return visible_sprites; }
     SpriteGroup* getVisibleSprites() { return &visible_sprites; }
+    SpatialGrid* getVisibleGrid() { return &visible_grid; }
     const SpriteGroup& getObstacleSprites() const { return obstacle_sprites; }
-    std::shared_ptr<Player> getPlayer() const { return player; }
+    const CollisionGrid& getCollisionGrid() const { return collision_grid; }
+    const SpriteGroup* getStaticSprites() const { return &static_sprites; }
+    std::shared_ptr<Player> getPlayer() const { return registry.player; }
+    // Simulation ticks run so far; the one render interpolation is working towards
+    Uint32 getTick() const { return tick; }
+    // Simulation time in ms; cooldowns and timers run on this so they follow ticks, not the wall clock
+    Uint32 getTime() const { return static_cast<Uint32>(static_cast<Uint64>(tick) * 1000 / TICK_RATE); }
+    const AiTierStats& getAiStats() const { return ai_scheduler.getStats(); }
+    // Threads for the enemy read phases, counting the main thread; 0 = one per core
+    void setJobThreads(unsigned threads) { jobs.setThreads(threads); }
+    // Called at the end of a tick with the area of each static tile removed during it
+    void setStaticChangeHook(std::function<void(const SDL_Rect&)> hook) { static_change_hook = std::move(hook); }
 
 private:
     SDL_Renderer* renderer;
+    Uint32 tick = 0;         // simulation ticks run, advanced at the start of update()
+    EnemyStore enemy_store;  // declared before the groups: enemies release their slots on destruction
+    SpriteRegistry registry;
     SpriteGroup visible_sprites;
+    SpriteGroup static_sprites;
     SpriteGroup obstacle_sprites;
+    CollisionGrid collision_grid;
     SpriteGroup attackable_sprites;
     SpriteGroup attack_sprites;
-
-    std::shared_ptr<Player> player;
+    SpatialGrid visible_grid;
+    SpatialGrid combat_grid;
+    std::vector<Sprite*> hits;           // scratch for combat queries
+    SpatialHash enemy_hash;
+    HierarchicalPathfinder pathfinder;
+    FlowField flow_field;
+    AiScheduler ai_scheduler;
+    SDL_Point wake_extent{0, 0};  // ai_wake_extent(), fixed once loaded
+    std::vector<size_t> awake_slots;
+    JobSystem jobs;
+    std::vector<EnemyIntent> enemy_intents;
+    int map_columns = 0;
+    int map_rows = 0;
+    std::vector<SDL_Rect> static_changes;  // removed this tick, re-baked after the flush
+    std::function<void(const SDL_Rect&)> static_change_hook;
+
+    std::vector<std::shared_ptr<SDL_Texture>> preloaded_textures;
 };
@@ -0,0 +1,212 @@
+#pragma once
+// Asynchronous, level-filtered logging for code that runs inside the frame loop.
+//
+// Messages are formatted on the calling thread into a fixed-size slot of a
+// lock-free ring buffer and written out by a background thread, so an enabled
+// log site never waits on I/O; when the ring is full the message is dropped and
+// counted. Sites below DOKUTSU_LOG_LEVEL are compiled out, and the rest cost a
+// single branch when their level or category is switched off at runtime.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+enum class LogCategory : uint8_t {
+    General,
+    Collision,
+    Combat,
+    AI,
+    Render,
+    Assets,
+    Count
+};
+
+// Minimum level compiled in: 0 = trace ... 4 = error
+#ifndef DOKUTSU_LOG_LEVEL
+#define DOKUTSU_LOG_LEVEL 1
+#endif
+
+// Whether sites at `level` survive compilation. Written as `level + 1 >` so the
+// trace build (level 0) doesn't trip -Wtype-limits on an always-true `>= 0`.
+constexpr bool log_compiled_in(LogLevel level) {
+    return static_cast<int>(level) + 1 > DOKUTSU_LOG_LEVEL;
+}
+
+// Lets GCC and Clang check log format strings against their arguments
+#if defined(__GNUC__) || defined(__clang__)
+#define DOKUTSU_PRINTF_FORMAT(format_index, first_arg) __attribute__((format(printf, format_index, first_arg)))
+#else
+#define DOKUTSU_PRINTF_FORMAT(format_index, first_arg)
+#endif
+
+const size_t LOG_RING_SIZE = 1024;  // must be a power of two
+const size_t LOG_MESSAGE_SIZE = 192;
+
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    bool enabled(LogLevel level, LogCategory category) const {
+        return level >= runtime_level.load(std::memory_order_relaxed) &&
+               (category_mask.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(category)));
+    }
+
+    void setLevel(LogLevel level) { runtime_level.store(level, std::memory_order_relaxed); }
+
+    void setCategoryEnabled(LogCategory category, bool on) {
+        unsigned bit = 1u << static_cast<unsigned>(category);
+        if (on) category_mask.fetch_or(bit, std::memory_order_relaxed);
+        else category_mask.fetch_and(~bit, std::memory_order_relaxed);
+    }
+
+    // Never blocks: claims a slot or drops the message if the consumer is behind.
+    // (Format indices count the implicit `this` as argument 1.)
+    DOKUTSU_PRINTF_FORMAT(4, 5)
+    void write(LogLevel level, LogCategory category, const char* format, ...) {
+        size_t position = head.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &ring[position & (LOG_RING_SIZE - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        slot->category = category;
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(slot->text, LOG_MESSAGE_SIZE, format, args);
+        va_end(args);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    static bool parseLevel(const std::string& name, LogLevel& level) {
+        static const char* names[] = {"trace", "debug", "info", "warn", "error", "off"};
+        for (size_t i = 0; i < 6; ++i) {
+            if (name == names[i]) {
+                level = static_cast<LogLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ~Logger() {
+        running.store(false, std::memory_order_release);
+        if (worker.joinable()) worker.join();
+        drain();
+
+        size_t lost = droppedCount();
+        if (lost) std::fprintf(stderr, "[log] %zu message(s) dropped, ring buffer full\n", lost);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::Info;
+        LogCategory category = LogCategory::General;
+        char text[LOG_MESSAGE_SIZE];
+    };
+
+    Logger() {
+        for (size_t i = 0; i < LOG_RING_SIZE; ++i) ring[i].sequence.store(i, std::memory_order_relaxed);
+        worker = std::thread([this]() {
+            while (running.load(std::memory_order_acquire)) {
+                if (!drain()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        });
+    }
+
+    // Single consumer: writes out every published slot, returns whether anything was written.
+    bool drain() {
+        bool wrote = false;
+        for (;;) {
+            Slot& slot = ring[tail & (LOG_RING_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;
+
+            FILE* out = slot.level >= LogLevel::Warn ? stderr : stdout;
+            std::fprintf(out, "[%s/%s] %s\n", levelName(slot.level), categoryName(slot.category), slot.text);
+
+            slot.sequence.store(tail + LOG_RING_SIZE, std::memory_order_release);
+            tail++;
+            wrote = true;
+        }
+        if (wrote) std::fflush(stdout);
+        return wrote;
+    }
+
+    static const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace: return "trace";
+            case LogLevel::Debug: return "debug";
+            case LogLevel::Info:  return "info";
+            case LogLevel::Warn:  return "warn";
+            case LogLevel::Error: return "error";
+            default:              return "?";
+        }
+    }
+
+    static const char* categoryName(LogCategory category) {
+        switch (category) {
+            case LogCategory::General:   return "general";
+            case LogCategory::Collision: return "collision";
+            case LogCategory::Combat:    return "combat";
+            case LogCategory::AI:        return "ai";
+            case LogCategory::Render:    return "render";
+            case LogCategory::Assets:    return "assets";
+            default:                     return "?";
+        }
+    }
+
+    std::array<Slot, LOG_RING_SIZE> ring;
+    std::atomic<size_t> head{0};
+    size_t tail = 0;
+    std::atomic<size_t> dropped{0};
+
+    std::atomic<LogLevel> runtime_level{LogLevel::Info};
+    std::atomic<unsigned> category_mask{~0u};
+    std::atomic<bool> running{true};
+    std::thread worker;
+};
+
+#define LOG_AT(level, category, ...)                                                    \
+    do {                                                                                \
+        if constexpr (log_compiled_in(level)) {                                         \
+            if (Logger::instance().enabled(level, category))                            \
+                Logger::instance().write(level, category, __VA_ARGS__);                 \
+        }                                                                               \
+    } while (0)
+
+#define LOG_TRACE(category, ...) LOG_AT(LogLevel::Trace, LogCategory::category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(LogLevel::Debug, LogCategory::category, __VA_ARGS__)
+#define LOG_INFO(category, ...)  LOG_AT(LogLevel::Info,  LogCategory::category, __VA_ARGS__)
+#define LOG_WARN(category, ...)  LOG_AT(LogLevel::Warn,  LogCategory::category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG_AT(LogLevel::Error, LogCategory::category, __VA_ARGS__)
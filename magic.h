@@ -20,8 +20,7 @@ public:
             SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, 0, 0, 0));
             createdInternally = true;
         } else {
-            std::string status = player->getStatus();
-            status = status.substr(0, status.find('_'));
+            std::string status = direction_name(player->getFacing());
             std::string full_path = texture_path;
 
             surface = IMG_Load(full_path.c_str());
@@ -43,8 +42,7 @@ public:
         rect.w = surface->w;
         rect.h = surface->h;
 
-        std::string status = player->getStatus();
-        status = status.substr(0, status.find('_'));
+        std::string status = direction_name(player->getFacing());
 
         if (status == "right") {
             rect.x = player_rect.x + player_rect.w;
@@ -79,7 +77,7 @@ public:
 
     SDL_Rect getRect() const override { return rect; }
     SDL_Rect getHitbox() const override { return hitbox; }
-    std::shared_ptr<SDL_Texture> getTexture() const { return texture; }
+    SDL_Texture* getTexture() const override { return texture.get(); }
 
     ~Magic() {
     }
@@ -6,19 +6,70 @@
 #include "player.h"
 #include "weapon.h"
 #include "ui.h"
+#include "bench.h"
+#include "profiler.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+enum class VsyncMode {
+    Off,       // render uncapped
+    On,
+    Adaptive   // late frames tear instead of waiting a whole refresh; falls back to On
+};
+
+struct GameOptions {
+    bool headless = false;   // dummy video driver + offscreen software renderer
+    VsyncMode vsync = VsyncMode::On;
+    int bench_frames = 600;
+    int bench_enemies = 0;    // extra enemies spawned around the player for the benchmark
+    unsigned threads = 0;     // enemy update threads, main thread included; 0 = one per core
+    std::string profile_csv;  // written when the run ends (profiler builds only)
+};
 
 class Game {
 public:
 
-    Game() {
+    Game(const GameOptions& options = {}) : options(options) {
 
         // SDL2 Boilerplate
 
+        if (options.headless) {
+            SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        }
+
         if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             std::cerr << "SDL Could not initialize! SDL_Error:" << SDL_GetError() <<"\n";
             exit(1);
         }
 
+        if (options.headless) {
+            createOffscreenRenderer();
+        } else {
+            createWindowRenderer();
+        }
+
+        // Level Initialization, Gameplay, Etc.
+        level = std::make_unique<Level>(renderer);
+        level->setJobThreads(options.threads);
+        texture_cache.report(std::cout);
+    }
+
+    ~Game() {
+        // Release every texture handle while the renderer is still alive
+        level.reset();
+        SDL_DestroyRenderer(renderer);
+        if (window) SDL_DestroyWindow(window);
+        if (target) SDL_FreeSurface(target);
+        SDL_Quit();
+    }
+
+    void createWindowRenderer() {
         window = SDL_CreateWindow("Dōkutsu",
                                 SDL_WINDOWPOS_CENTERED,
                                 SDL_WINDOWPOS_CENTERED,
@@ -30,7 +81,10 @@ public:
             exit(1);
         }
 
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        Uint32 flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
+        if (options.vsync != VsyncMode::Off) flags |= SDL_RENDERER_PRESENTVSYNC;
+
+        renderer = SDL_CreateRenderer(window, -1, flags);
         if (!renderer) {
             std::cerr << "SDL Renderer could not be created! SDL_Error:" << SDL_GetError() << "\n";
             SDL_DestroyWindow(window);
@@ -38,33 +92,70 @@ public:
             exit(1);
         }
 
-        // Level Initialization, Gameplay, Etc.
-        level = std::make_unique<Level>(renderer);
+        // Only the OpenGL backends expose adaptive swap; the renderer keeps its context current
+        if (options.vsync == VsyncMode::Adaptive && SDL_GL_SetSwapInterval(-1) != 0) {
+            std::cerr << "Adaptive vsync unavailable (" << SDL_GetError() << "), using regular vsync\n";
+        }
     }
 
-    ~Game() {
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        SDL_Quit();
+    // Renders into a plain surface: no window, no vsync
+    void createOffscreenRenderer() {
+        target = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!target) {
+            std::cerr << "Offscreen surface could not be created! SDL_Error:" << SDL_GetError() << "\n";
+            SDL_Quit();
+            exit(1);
+        }
+
+        renderer = SDL_CreateSoftwareRenderer(target);
+        if (!renderer) {
+            std::cerr << "Software renderer could not be created! SDL_Error:" << SDL_GetError() << "\n";
+            SDL_FreeSurface(target);
+            SDL_Quit();
+            exit(1);
+        }
     }
 
+// Fixed-timestep loop: the simulation advances in TICK_RATE steps however long
+// frames take, and rendering interpolates entities between the last two ticks.
 void run() {
     bool running = true;
     SDL_Event event;
-    Uint32 frameDelay = 1000 / FPS;
-    Uint32 frameStart;
-    int frameTime;
+    const double tick_ms = 1000.0 / TICK_RATE;
+    double accumulator = 0.0;
+    Uint64 previous = SDL_GetPerformanceCounter();
 
-    Camera camera(renderer, level->getVisibleSprites());
+    Camera camera(renderer, level->getVisibleGrid(), level->getStaticSprites());
+    level->setStaticChangeHook([&camera](const SDL_Rect& area) { camera.rebuildStatic(area); });
     UI ui(renderer, level->getPlayer());
 
         while (running) {
-            frameStart = SDL_GetTicks();
+            PROFILE_FRAME_BEGIN();
+
+            Uint64 now = SDL_GetPerformanceCounter();
+            // Clamped so a long stall doesn't queue up more ticks than we can ever catch up on
+            accumulator += std::min(ticks_to_ms(now - previous), MAX_FRAME_MS);
+            previous = now;
 
             while (SDL_PollEvent(&event)) {
                 if (event.type == SDL_QUIT) {
                     running = false;
                 }
+                camera.handleEvent(event);
+                PROFILE_HANDLE_EVENT(event);
+            }
+
+            int ticks = 0;
+            while (accumulator >= tick_ms && ticks < MAX_TICKS_PER_FRAME) {
+                if (!level->getPlayer()->isAlive()) break;
+                level->getPlayer()->handleInput();
+                level->update();
+                accumulator -= tick_ms;
+                ticks++;
+            }
+            // Still behind after the per-frame cap: drop the backlog and run slow instead of spiralling
+            if (accumulator >= tick_ms) {
+                accumulator = std::fmod(accumulator, tick_ms);
             }
 
             if (!level->getPlayer()->isAlive()) {
@@ -73,37 +164,218 @@ void run() {
                 continue;
             }
 
-            level->getPlayer()->handleInput();
-            level->update();
-            camera.centerOn(level->getPlayer()->getRect());
+            float alpha = static_cast<float>(accumulator / tick_ms);
+            camera.centerOn(*level->getPlayer(), alpha, level->getTick());
 
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
             SDL_RenderClear(renderer);
 
-            camera.draw();
+            camera.draw(alpha, level->getTick());
             ui.update();
             ui.render();
+            PROFILE_DRAW_OVERLAY(renderer);
 
             SDL_RenderPresent(renderer);
+            PROFILE_FRAME_END();
+        }
 
-            frameTime = SDL_GetTicks() - frameStart;
-            if (frameDelay > frameTime) {
-                SDL_Delay(frameDelay - frameTime);
-            }
+        level->setStaticChangeHook(nullptr);
+        dumpProfile();
+        PROFILE_SHUTDOWN();  // before ui closes SDL_ttf
+}
+
+void dumpProfile() {
+    if (options.profile_csv.empty()) return;
+    if (!PROFILE_ENABLED) {
+        std::cerr << "--profile-csv ignored: rebuild with -DDOKUTSU_PROFILE to enable the profiler\n";
+        return;
+    }
+    PROFILE_DUMP_CSV(options.profile_csv);
+}
+
+
+// Fixed number of frames with scripted input and no frame pacing, one simulation tick per frame; prints per-phase timings
+void runBenchmark() {
+    SDL_Event event;
+    Camera camera(renderer, level->getVisibleGrid(), level->getStaticSprites());
+    level->setStaticChangeHook([&camera](const SDL_Rect& area) { camera.rebuildStatic(area); });
+    UI ui(renderer, level->getPlayer());
+    BenchTimings timings;
+    AiTierStats ai_totals;
+
+    if (options.bench_enemies > 0) {
+        int spawned = level->spawn_enemies(options.bench_enemies);
+        std::cout << "Benchmark: spawned " << spawned << " extra enemies\n";
+    }
+
+    int frame = 0;
+    for (; frame < options.bench_frames; ++frame) {
+        PROFILE_FRAME_BEGIN();
+        while (SDL_PollEvent(&event)) {}
+
+        if (!level->getPlayer()->isAlive()) {
+            std::cout << "Player has died. Ending benchmark early.\n";
+            break;
         }
 
+        level->getPlayer()->handleInput(scripted_input(frame));
+
+        collision_ticks = 0;
+        Uint64 start = SDL_GetPerformanceCounter();
+        level->update();
+        double update_ms = ticks_to_ms(SDL_GetPerformanceCounter() - start);
+        double collision_ms = ticks_to_ms(collision_ticks);
+        timings.record(BenchPhase::Update, update_ms - collision_ms);
+        timings.record(BenchPhase::Collision, collision_ms);
+
+        const AiTierStats& ai = level->getAiStats();
+        ai_totals.active += ai.active;
+        ai_totals.nearby_updated += ai.nearby_updated;
+        ai_totals.nearby_skipped += ai.nearby_skipped;
+        ai_totals.asleep += ai.asleep;
+
+        camera.centerOn(level->getPlayer()->getRect());
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        start = SDL_GetPerformanceCounter();
+        camera.draw();
+        double draw_ms = ticks_to_ms(SDL_GetPerformanceCounter() - start);
+        const CameraStats& stats = camera.getStats();
+        timings.record(BenchPhase::Cull, stats.cull_ms);
+        timings.record(BenchPhase::Sort, stats.sort_ms);
+        timings.record(BenchPhase::Draw, draw_ms - stats.cull_ms - stats.sort_ms);
+
+        start = SDL_GetPerformanceCounter();
+        ui.update();
+        ui.render();
+        timings.record(BenchPhase::UI, ticks_to_ms(SDL_GetPerformanceCounter() - start));
+
+        SDL_RenderPresent(renderer);
+        PROFILE_FRAME_END();
+    }
+
+    std::cout << "Benchmark: " << frame << " frames\n";
+    timings.report(std::cout);
+    report_ai_tiers(std::cout, ai_totals, frame);
+    level->setStaticChangeHook(nullptr);
+    dumpProfile();
+    PROFILE_SHUTDOWN();  // before ui closes SDL_ttf
 }
 
 
 private:
+    GameOptions options;
     SDL_Window* window = nullptr;
+    SDL_Surface* target = nullptr;
     SDL_Renderer* renderer = nullptr;
     std::unique_ptr<Level> level;
 
 };
 
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--headless] [--bench-pathfinding] [--bench-animate] [--bench-store] [--bench-jobs] [--frames N] [--enemies N] [--threads N] [--profile-csv FILE] [--vsync off|on|adaptive] [--log-level LEVEL]\n";
+}
+
+// Whole-string base-10 integer in [min, max]
+bool parse_int(const char* text, long min, long max, int& out) {
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < min || value > max) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
 int main(int argc, char* argv[]) {
-    Game game;
-    game.run();
+    GameOptions options;
+    bool bench_pathfinding_only = false;
+    bool bench_animate_only = false;
+    bool bench_store_only = false;
+    bool bench_jobs_only = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(argv[i], "--bench-pathfinding") == 0) {
+            bench_pathfinding_only = true;
+        } else if (std::strcmp(argv[i], "--bench-animate") == 0) {
+            bench_animate_only = true;
+        } else if (std::strcmp(argv[i], "--bench-store") == 0) {
+            bench_store_only = true;
+        } else if (std::strcmp(argv[i], "--bench-jobs") == 0) {
+            bench_jobs_only = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], 1, INT_MAX, options.bench_frames)) {
+                std::cerr << "--frames needs a positive number, got: " << argv[i] << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            if (!parse_int(argv[++i], 0, INT_MAX, options.bench_enemies)) {
+                std::cerr << "--enemies needs a number >= 0, got: " << argv[i] << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            int threads = 0;
+            if (!parse_int(argv[++i], 0, JOB_MAX_THREADS, threads)) {
+                std::cerr << "--threads needs a number from 0 to " << JOB_MAX_THREADS << ", got: " << argv[i] << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+            options.threads = static_cast<unsigned>(threads);
+        } else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            options.profile_csv = argv[++i];
+        } else if (std::strcmp(argv[i], "--vsync") == 0 && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "off") options.vsync = VsyncMode::Off;
+            else if (mode == "on") options.vsync = VsyncMode::On;
+            else if (mode == "adaptive") options.vsync = VsyncMode::Adaptive;
+            else {
+                std::cerr << "Unknown vsync mode: " << mode << " (off, on, adaptive)\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            LogLevel level;
+            if (!Logger::parseLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << " (trace, debug, info, warn, error, off)\n";
+                return 1;
+            }
+            Logger::instance().setLevel(level);
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench_pathfinding_only) {
+        bench_pathfinding(std::cout, chase_range_tiles());  // no window or assets needed
+        bench_hierarchical(std::cout);
+        return 0;
+    }
+
+    if (bench_animate_only) {
+        bench_animate(std::cout);
+        return 0;
+    }
+
+    if (bench_store_only) {
+        bench_enemy_store(std::cout);
+        return 0;
+    }
+
+    if (bench_jobs_only) {
+        unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        bench_jobs(std::cout, threads);
+        return 0;
+    }
+
+    Game game(options);
+    if (options.headless) {
+        game.runBenchmark();
+    } else {
+        game.run();
+    }
     return 0;
 }
@@ -0,0 +1,150 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "collision_grid.h"
+
+const float PATH_DIAGONAL_COST = 1.41421356f;
+
+// Octile distance: exact cost on an open 8-connected grid
+float octile_distance(int dx, int dy) {
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    return static_cast<float>(dx + dy) + (PATH_DIAGONAL_COST - 2.0f) * static_cast<float>(std::min(dx, dy));
+}
+
+// A* over the tiles of a CollisionGrid, 8-connected, no cutting past blocked corners.
+//
+// Per-node state lives in arrays sized to the grid and reused across searches:
+// a node's entries are only trusted when its stamp matches the current search,
+// so starting a search is O(1) and nothing is allocated once the arrays and the
+// heap have grown. The open list is a binary heap with lazy deletion.
+class GridPathfinder {
+public:
+    explicit GridPathfinder(const CollisionGrid* grid = nullptr) : grid(grid) {}
+
+    void setGrid(const CollisionGrid* new_grid) { grid = new_grid; }
+
+    // Fills `out` with the cells after `start` up to and including `goal`.
+    // Start and goal are allowed to be blocked (entities straddle obstacles);
+    // gives up after `max_expansions` nodes.
+    bool findPath(SDL_Point start, SDL_Point goal, std::vector<SDL_Point>& out, int max_expansions = 1 << 30) {
+        out.clear();
+        expanded = 0;
+        if (!grid) return false;
+        SDL_Rect whole = { 0, 0, grid->getColumns(), grid->getRows() };
+        return findPathWithin(start, goal, whole, out, max_expansions);
+    }
+
+    // Same, but never leaves `area` (in cells). Appends to `out` instead of replacing it.
+    bool findPathWithin(SDL_Point start, SDL_Point goal, const SDL_Rect& area, std::vector<SDL_Point>& out,
+                        int max_expansions = 1 << 30) {
+        expanded = 0;
+        if (!grid || !grid->inBounds(start.x, start.y) || !grid->inBounds(goal.x, goal.y)) return false;
+        if (!cellInArea(start, area) || !cellInArea(goal, area)) return false;
+        if (start.x == goal.x && start.y == goal.y) return true;
+
+        prepare();
+        int columns = grid->getColumns();
+        int start_index = start.y * columns + start.x;
+        int goal_index = goal.y * columns + goal.x;
+
+        open.clear();
+        touch(start_index, 0.0f, -1);
+        open.push_back({ octile_distance(goal.x - start.x, goal.y - start.y), start_index });
+
+        static const int DX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+        static const int DY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), heap_greater);
+            OpenNode node = open.back();
+            open.pop_back();
+
+            int index = node.index;
+            if (closed[index] == search_id) continue;  // stale duplicate
+            closed[index] = search_id;
+
+            if (index == goal_index) {
+                size_t first = out.size();
+                for (int at = goal_index; at != start_index; at = parent[at]) {
+                    out.push_back({ at % columns, at / columns });
+                }
+                std::reverse(out.begin() + first, out.end());
+                return true;
+            }
+            if (++expanded > max_expansions) return false;
+
+            int col = index % columns;
+            int row = index / columns;
+            for (int d = 0; d < 8; ++d) {
+                int nc = col + DX[d];
+                int nr = row + DY[d];
+                if (!cellInArea({ nc, nr }, area)) continue;
+
+                int next = nr * columns + nc;
+                if (next != goal_index && grid->isBlocked(nc, nr)) continue;
+                if (d >= 4 && (grid->isBlocked(col + DX[d], row) || grid->isBlocked(col, row + DY[d]))) continue;
+                if (closed[next] == search_id) continue;
+
+                float cost = cost_so_far[index] + (d >= 4 ? PATH_DIAGONAL_COST : 1.0f);
+                if (stamp[next] == search_id && cost >= cost_so_far[next]) continue;
+
+                touch(next, cost, index);
+                open.push_back({ cost + octile_distance(goal.x - nc, goal.y - nr), next });
+                std::push_heap(open.begin(), open.end(), heap_greater);
+            }
+        }
+        return false;
+    }
+
+    // Nodes expanded by the last search
+    int lastExpanded() const { return expanded; }
+
+private:
+    struct OpenNode {
+        float f;
+        int index;
+    };
+
+    static bool heap_greater(const OpenNode& a, const OpenNode& b) { return a.f > b.f; }
+
+    static bool cellInArea(SDL_Point cell, const SDL_Rect& area) {
+        return cell.x >= area.x && cell.y >= area.y && cell.x < area.x + area.w && cell.y < area.y + area.h;
+    }
+
+    void prepare() {
+        size_t cells = static_cast<size_t>(grid->getColumns()) * grid->getRows();
+        if (stamp.size() != cells) {
+            stamp.assign(cells, 0);
+            closed.assign(cells, 0);
+            cost_so_far.assign(cells, 0.0f);
+            parent.assign(cells, -1);
+            search_id = 0;
+        }
+        if (++search_id == 0) {  // wrapped: old stamps could collide
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            search_id = 1;
+        }
+    }
+
+    void touch(int index, float cost, int from) {
+        stamp[index] = search_id;
+        cost_so_far[index] = cost;
+        parent[index] = from;
+    }
+
+    const CollisionGrid* grid = nullptr;
+    uint32_t search_id = 0;
+    int expanded = 0;
+
+    std::vector<uint32_t> stamp;   // search that last set cost_so_far / parent
+    std::vector<uint32_t> closed;  // search that last expanded the node
+    std::vector<float> cost_so_far;
+    std::vector<int> parent;
+    std::vector<OpenNode> open;
+};
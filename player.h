@@ -1,12 +1,17 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include "entity.h"
+#include "registry.h"
 #include "support.h"
 #include "settings.h"
+#include "texture_cache.h"
+#include "animation.h"
 
 class Weapon;
 class Magic;
@@ -18,13 +23,66 @@ enum class PlayerActionState {
 	Casting
 };
 
-enum class Direction {
+enum class Direction : uint8_t {
 	Up,
 	Down,
 	Left,
 	Right
 };
 
+const size_t DIRECTION_COUNT = 4;
+
+// Also the prefix of the player's animation folders and weapon images
+const char* direction_name(Direction direction) {
+    switch (direction) {
+        case Direction::Up:    return "up";
+        case Direction::Left:  return "left";
+        case Direction::Right: return "right";
+        default:               return "down";
+    }
+}
+
+// Which clip set the player shows; casting reuses the attack clips for now
+enum class PlayerClip : uint8_t {
+    Move,
+    Idle,
+    Attack
+};
+
+const size_t PLAYER_CLIP_COUNT = 3;
+
+// Folder suffix per PlayerClip, after the direction ("up", "up_idle", "up_attack")
+const char* const PLAYER_CLIP_SUFFIX[PLAYER_CLIP_COUNT] = { "", "_idle", "_attack" };
+
+// One clip per (clip set, direction), indexed directly
+using PlayerClipTable = std::array<std::array<AnimationClip, DIRECTION_COUNT>, PLAYER_CLIP_COUNT>;
+
+// Snapshot of the keys the player responds to, so input can also be scripted
+struct InputState {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+    bool attack = false;
+    bool magic = false;
+    bool swap_weapon = false;
+    bool swap_magic = false;
+
+    static InputState fromKeyboard() {
+        const Uint8* keystate = SDL_GetKeyboardState(NULL);
+        InputState input;
+        input.up = keystate[SDL_SCANCODE_UP];
+        input.down = keystate[SDL_SCANCODE_DOWN];
+        input.left = keystate[SDL_SCANCODE_LEFT];
+        input.right = keystate[SDL_SCANCODE_RIGHT];
+        input.attack = keystate[SDL_SCANCODE_SPACE];
+        input.magic = keystate[SDL_SCANCODE_E];
+        input.swap_weapon = keystate[SDL_SCANCODE_Q];
+        input.swap_magic = keystate[SDL_SCANCODE_W];
+        return input;
+    }
+};
+
 class Player : public Entity {
 public:
     Player(SDL_Renderer* renderer,
@@ -39,35 +97,20 @@ public:
 
 
 
-        SDL_Surface* tempSurface = IMG_Load("./graphics/test/player.png");
-        if (!tempSurface) {
-            std::cerr << "Failed to load image: " << IMG_GetError() << std::endl;
-            exit(1);
-        }
-
-        texture.reset(SDL_CreateTextureFromSurface(renderer, tempSurface), SDL_DestroyTexture);
+        texture = texture_cache.load(renderer, "./graphics/test/player.png");
         if (!texture) {
-            std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
-            SDL_FreeSurface(tempSurface);
+            std::cerr << "Failed to load player texture" << std::endl;
             exit(1);
         }
 
-        rect = { pos.x, pos.y, tempSurface->w, tempSurface->h };
+        SDL_Point size = texture_size(texture);
+        rect = { pos.x, pos.y, size.x, size.y };
         int insetY = 10;
         hitbox = {
             pos.x,
             pos.y + insetY,
-            tempSurface->w,
-            tempSurface->h - 2 * insetY
-        };
-
-        SDL_FreeSurface(tempSurface);
-
-        animations = {
-            { "up",   {} }, { "up_idle", {} }, { "up_attack", {} },
-            { "down", {} }, { "down_idle", {} }, { "down_attack", {} },
-            { "left", {} }, { "left_idle", {} }, { "left_attack", {} },
-            { "right", {} }, { "right_idle", {} }, { "right_attack", {} },
+            size.x,
+            size.y - 2 * insetY
         };
 
         import_player_assets();
@@ -76,83 +119,39 @@ public:
 void import_player_assets() {
     std::string path = "./graphics/player/";
 
-    for (auto& [k, v] : animations) {
-        std::string completePath = path + k;
-        std::vector<std::filesystem::directory_entry> entries;
-        std::error_code ec;
-        if (!std::filesystem::exists(completePath, ec)) {
-            std::cerr << "player::import_player_assets: missing animation folder at: " << completePath << "\n";
-            continue;
-        }
-
-        for (const auto& entry : std::filesystem::directory_iterator(completePath)) {
-            if (entry.is_regular_file()) entries.push_back(entry);
-        }
-
-        std::sort(entries.begin(), entries.end(),
-            [](const auto& a, const auto& b) {
-                return a.path().filename() < b.path().filename();
-            });
-
-        std::vector<std::shared_ptr<SDL_Surface>> surface_list;
-        for (const auto& entry : entries) {
-            std::string full_path = entry.path().string();
-            std::shared_ptr<SDL_Surface> image(IMG_Load(full_path.c_str()), SDL_FreeSurface);
-
-            if (!image) {
-                std::cerr << "Failed to load image: " << full_path << " | " << IMG_GetError() << std::endl;
-                continue;
-            }
-
-            surface_list.push_back(std::move(image));
+    for (size_t clip_set = 0; clip_set < PLAYER_CLIP_COUNT; ++clip_set) {
+        for (size_t dir = 0; dir < DIRECTION_COUNT; ++dir) {
+            animations[clip_set][dir] = load_animation_clip(renderer,
+                path + direction_name(static_cast<Direction>(dir)) + PLAYER_CLIP_SUFFIX[clip_set]);
         }
-
-        v = std::move(surface_list);
     }
 }
 void updateAnimationStatus() {
-    std::string dirStr;
-    switch (facingDirection) {
-        case Direction::Up:    dirStr = "up"; break;
-        case Direction::Down:  dirStr = "down"; break;
-        case Direction::Left:  dirStr = "left"; break;
-        case Direction::Right: dirStr = "right"; break;
-    }
-
-    std::string newStatus;
+    PlayerClip newClip = PlayerClip::Idle;
     switch (actionState) {
         case PlayerActionState::Idle:
-            newStatus = dirStr + "_idle";
+            newClip = PlayerClip::Idle;
             break;
         case PlayerActionState::Moving:
-            newStatus = dirStr;
+            newClip = PlayerClip::Move;
             break;
         case PlayerActionState::Attacking:
-            newStatus = dirStr + "_attack";
-            break;
-        case PlayerActionState::Casting:
-            newStatus = dirStr + "_attack"; // same for now
+        case PlayerActionState::Casting:  // same for now
+            newClip = PlayerClip::Attack;
             break;
     }
 
-    if (newStatus != status) {
-        status = newStatus;
+    if (newClip != clip || facingDirection != clipDirection) {
+        clip = newClip;
+        clipDirection = facingDirection;
         frame_index = 0.0f;
         current_frame = -1;
     }
 }
 
     void animate() {
-        // Flashing effect when player is invulnerable
-        if (!vulnerable) {
-            int alpha = (SDL_GetTicks() / 100) % 2 ? 128 : 255;
-            SDL_SetTextureAlphaMod(texture.get(), alpha);
-        } else {
-            SDL_SetTextureAlphaMod(texture.get(), 255);
-        }
-
-        // Grab the animation frames for the current status
-        auto& animation = animations[status];
+        // Grab the animation frames for the current clip
+        const AnimationClip& animation = animations[static_cast<size_t>(clip)][static_cast<size_t>(clipDirection)];
         int anim_size = static_cast<int>(animation.size());
         if (anim_size == 0) return;
 
@@ -168,19 +167,11 @@ void updateAnimationStatus() {
         // Only update texture if frame changed
         if (new_frame != current_frame) {
             current_frame = new_frame;
-            auto& surface = animation[current_frame];
-            if (!surface) return;
-
-            texture.reset(SDL_CreateTextureFromSurface(renderer, surface.get()), SDL_DestroyTexture);
-            if (!texture) {
-                std::cerr << "[ERROR] Failed to create texture from surface at frame "
-                          << current_frame << ": " << SDL_GetError() << "\n";
-                return;
-            }
+            texture = animation.frames[current_frame];
 
             // Update only the size — leave position to be handled in Player::update()
-            rect.w = surface->w;
-            rect.h = surface->h;
+            rect.w = animation.sizes[current_frame].x;
+            rect.h = animation.sizes[current_frame].y;
         }
     }
 
@@ -188,6 +179,15 @@ void updateAnimationStatus() {
 
 
 
+    // Flashing effect when player is invulnerable
+    Uint8 flashAlpha() const {
+        return (!vulnerable && (SDL_GetTicks() / 100) % 2) ? 128 : 255;
+    }
+
+    void submit(SpriteBatch& batch, SDL_Point offset) override {
+        batch.push(texture.get(), screen_rect(rect, offset), {255, 255, 255, flashAlpha()});
+    }
+
     void draw(SDL_Renderer* renderer, SDL_Point offset) override {
         SDL_Rect shifted = {
             rect.x - offset.x,
@@ -195,6 +195,8 @@ void updateAnimationStatus() {
             rect.w,
             rect.h
         };
+
+        SDL_SetTextureAlphaMod(texture.get(), flashAlpha());
         SDL_RenderCopy(renderer, texture.get(), nullptr, &shifted);
     }
 
@@ -202,17 +204,20 @@ void updateAnimationStatus() {
 // Input Handling
 
 void handleInput() {
-    const Uint8* keystate = SDL_GetKeyboardState(NULL);
-    bool spaceDown = keystate[SDL_SCANCODE_SPACE];
-    bool magicDown = keystate[SDL_SCANCODE_E];
+    handleInput(InputState::fromKeyboard());
+}
+
+void handleInput(const InputState& input) {
+    bool spaceDown = input.attack;
+    bool magicDown = input.magic;
 
     direction = {0, 0};
     SDL_Point rawDir = {0, 0};
 
-    if (keystate[SDL_SCANCODE_UP])    rawDir.y = -1;
-    if (keystate[SDL_SCANCODE_DOWN])  rawDir.y =  1;
-    if (keystate[SDL_SCANCODE_LEFT])  rawDir.x = -1;
-    if (keystate[SDL_SCANCODE_RIGHT]) rawDir.x =  1;
+    if (input.up)    rawDir.y = -1;
+    if (input.down)  rawDir.y =  1;
+    if (input.left)  rawDir.x = -1;
+    if (input.right) rawDir.x =  1;
 
     // Normalize movement direction and update facing
     if (rawDir.x != 0 || rawDir.y != 0) {
@@ -242,7 +247,7 @@ void handleInput() {
     // Handle attack state
     if (spaceDown && !attack_button_held && !attacking && !casting) {
         attacking = true;
-        attackTime = SDL_GetTicks();
+        attackTime = clock;
         actionState = PlayerActionState::Attacking;
         if (attack_callback) attack_callback();
     }
@@ -252,7 +257,7 @@ void handleInput() {
     // Handle magic state
     if (magicDown && !magic_button_held && !casting && !attacking) {
         casting = true;
-        magicCastTime = SDL_GetTicks();
+        magicCastTime = clock;
         actionState = PlayerActionState::Casting;
         if (magic_callback) magic_callback();
     }
@@ -260,22 +265,22 @@ void handleInput() {
     magic_button_held = magicDown;
 
     // Weapon swap
-    if (keystate[SDL_SCANCODE_Q] && !weapon_swapping) {
+    if (input.swap_weapon && !weapon_swapping) {
         weapon_swapping = true;
-        weaponSwapTime = SDL_GetTicks();
+        weaponSwapTime = clock;
         weapon_index = (1 + weapon_index) % weapons.size();
     }
 
     // Magic swap
-    if (keystate[SDL_SCANCODE_W] && !magic_swapping) {
+    if (input.swap_magic && !magic_swapping) {
         magic_swapping = true;
-        magicSwapTime = SDL_GetTicks();
+        magicSwapTime = clock;
         magic_index = (1 + magic_index) % magic.size();
     }
 }
 
 void cooldowns() {
-    Uint32 currentTime = SDL_GetTicks();
+    Uint32 currentTime = clock;
 
     if (attacking && currentTime - attackTime >= attack_cooldown) {
         attacking = false;
@@ -344,7 +349,7 @@ void takeDamage(int amount) {
 			alive = false;
 		}
         vulnerable = false;
-        hurt_time = SDL_GetTicks();
+        hurt_time = clock;
     }
 }
 
@@ -361,9 +366,10 @@ void takeDamage(int amount) {
     // Getters/Setters
 
     SDL_Rect getRect() const override { return rect; }
-    std::shared_ptr<SDL_Texture> getTexture() const { return texture; }
+    SDL_Texture* getTexture() const override { return texture.get(); }
     SDL_Rect getHitbox() const override { return hitbox; }
-    std::string getStatus() const { return status; }
+    // Direction of the clip being shown
+    Direction getFacing() const { return clipDirection; }
 	bool isAlive() const { return alive; }
 	SDL_FPoint getDirection() const { return direction; }
 
@@ -380,7 +386,8 @@ void takeDamage(int amount) {
     float speed = 5.0f;
     SDL_FPoint direction{0, 0};
 	SDL_FPoint normalizedDirection = {0, 0};
-	std::string status = "down";
+	PlayerClip clip = PlayerClip::Idle;
+	Direction clipDirection = Direction::Down;
 
     bool attacking = false;
     bool attack_button_held = false;
@@ -419,10 +426,14 @@ void takeDamage(int amount) {
 
 	bool alive = true;
 
+    // Simulation time in ms, set by the level at the start of each tick; cooldowns run on it
+    void setClock(Uint32 now) { clock = now; }
+
 
 private:
+    Uint32 clock = 0;
     std::shared_ptr<SDL_Texture> texture;
-    std::unordered_map<std::string, std::vector<std::shared_ptr<SDL_Surface>>> animations;
+    PlayerClipTable animations;
     SDL_Renderer* renderer = nullptr;
     SDL_Rect rect;
     std::function<void()> attack_callback;
@@ -434,16 +445,18 @@ std::shared_ptr<Player> createPlayer(
     SDL_Renderer* renderer,
     SDL_Point pos,
     std::initializer_list<SpriteGroup*> groups,
-    SpriteGroup* obstacles,
+    const CollisionGrid* collision,
     std::function<void()> attack_callback,
     std::function<void()> destroy_callback,
-    std::function<void()> magic_callback
+    std::function<void()> magic_callback,
+    SpriteRegistry* registry = nullptr
 ) {
     auto player = std::make_shared<Player>(renderer, pos, attack_callback, destroy_callback, magic_callback);
-    player->obstacleGroup = obstacles;
+    player->collisionGrid = collision;
 
     for (auto* group : groups) {
         group->add(player);
     }
+    if (registry) registry->player = player;
     return player;
 }
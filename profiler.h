@@ -0,0 +1,237 @@
+#pragma once
+// Frame profiler: RAII zones timed with SDL_GetPerformanceCounter, a per-frame
+// ring buffer of zone totals, a toggleable overlay (F3) and CSV dumps (F4).
+// Only compiled in when DOKUTSU_PROFILE is defined; otherwise every PROFILE_*
+// macro expands to nothing.
+
+#ifdef DOKUTSU_PROFILE
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "settings.h"
+
+const int PROFILE_MAX_ZONES = 32;
+const int PROFILE_HISTORY = 240;  // frames kept in the ring buffer
+
+struct ProfileFrame {
+    Uint64 frame_ticks = 0;
+    std::array<Uint64, PROFILE_MAX_ZONES> zone_ticks{};
+    std::array<Uint32, PROFILE_MAX_ZONES> zone_calls{};
+};
+
+class Profiler {
+public:
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // Sites sharing a name share a zone, so one kind of work gets one column
+    int registerZone(const char* name) {
+        for (size_t i = 0; i < zone_names.size(); ++i) {
+            if (std::strcmp(zone_names[i], name) == 0) return static_cast<int>(i);
+        }
+        if (zone_names.size() >= PROFILE_MAX_ZONES) {
+            std::cerr << "Profiler: too many zones, ignoring '" << name << "'\n";
+            return -1;
+        }
+        zone_names.push_back(name);
+        return static_cast<int>(zone_names.size()) - 1;
+    }
+
+    void add(int zone, Uint64 ticks) {
+        if (zone < 0) return;
+        current.zone_ticks[zone] += ticks;
+        current.zone_calls[zone]++;
+    }
+
+    void beginFrame() {
+        current = {};
+        frame_start = SDL_GetPerformanceCounter();
+    }
+
+    void endFrame() {
+        current.frame_ticks = SDL_GetPerformanceCounter() - frame_start;
+        history[frame_count % PROFILE_HISTORY] = current;
+        frame_count++;
+    }
+
+    void handleEvent(const SDL_Event& event) {
+        if (event.type != SDL_KEYDOWN || event.key.repeat) return;
+        if (event.key.keysym.sym == SDLK_F3) overlay_visible = !overlay_visible;
+        if (event.key.keysym.sym == SDLK_F4) dumpCSV("profile.csv");
+    }
+
+    // Rolling average over the ring buffer, in milliseconds
+    double averageMs(int zone) const {
+        size_t frames = std::min<size_t>(frame_count, PROFILE_HISTORY);
+        if (frames == 0) return 0.0;
+
+        Uint64 total = 0;
+        for (size_t i = 0; i < frames; ++i) {
+            total += zone < 0 ? history[i].frame_ticks : history[i].zone_ticks[zone];
+        }
+        return total * 1000.0 / SDL_GetPerformanceFrequency() / frames;
+    }
+
+    bool dumpCSV(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "Profiler: failed to open " << path << " for writing\n";
+            return false;
+        }
+
+        out << "frame,frame_ms";
+        for (const auto& name : zone_names) out << "," << name << "_ms," << name << "_calls";
+        out << "\n";
+
+        double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+        size_t frames = std::min<size_t>(frame_count, PROFILE_HISTORY);
+        for (size_t i = frame_count - frames; i < frame_count; ++i) {
+            const ProfileFrame& frame = history[i % PROFILE_HISTORY];
+            out << i << "," << frame.frame_ticks * ms_per_tick;
+            for (size_t z = 0; z < zone_names.size(); ++z) {
+                out << "," << frame.zone_ticks[z] * ms_per_tick << "," << frame.zone_calls[z];
+            }
+            out << "\n";
+        }
+
+        std::cout << "Profiler: wrote " << frames << " frames to " << path << "\n";
+        return true;
+    }
+
+    // One bar per zone, scaled so a full 60 FPS frame budget spans the bar area
+    void drawOverlay(SDL_Renderer* renderer) {
+        if (!overlay_visible) return;
+
+        const int x = WIDTH - OVERLAY_WIDTH - 10;
+        const int row_h = 18;
+        const int bar_x = x + 170;
+        const int bar_w = OVERLAY_WIDTH - 180;
+        const double budget_ms = 1000.0 / FPS;
+        int rows = static_cast<int>(zone_names.size()) + 1;
+
+        SDL_Rect background = { x, 10, OVERLAY_WIDTH, rows * row_h + 10 };
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+        SDL_RenderFillRect(renderer, &background);
+
+        bool refresh_labels = (frame_count % 30) == 0 || labels.size() != static_cast<size_t>(rows);
+        if (refresh_labels) labels.resize(rows);
+
+        for (int row = 0; row < rows; ++row) {
+            int zone = row - 1;  // row 0 is the whole frame
+            double ms = averageMs(zone);
+            int y = 15 + row * row_h;
+
+            SDL_Rect bar = { bar_x, y + 3, std::min(bar_w, static_cast<int>(bar_w * ms / budget_ms)), row_h - 6 };
+            if (ms > budget_ms) SDL_SetRenderDrawColor(renderer, 220, 60, 60, 255);
+            else SDL_SetRenderDrawColor(renderer, 80, 200, 120, 255);
+            SDL_RenderFillRect(renderer, &bar);
+
+            if (refresh_labels) {
+                char text[64];
+                std::snprintf(text, sizeof(text), "%-14s %6.2f", zone < 0 ? "frame" : zone_names[zone], ms);
+                labels[row] = renderLabel(renderer, text);
+            }
+            if (labels[row].texture) {
+                SDL_Rect dst = { x + 6, y, labels[row].w, labels[row].h };
+                SDL_RenderCopy(renderer, labels[row].texture.get(), nullptr, &dst);
+            }
+        }
+    }
+
+    bool overlayVisible() const { return overlay_visible; }
+
+    // Frees the overlay's font and label textures. Call while the renderer and
+    // SDL_ttf are still up: the profiler itself lives until static destruction.
+    void shutdown() {
+        labels.clear();
+        font.reset();
+    }
+
+private:
+    static const int OVERLAY_WIDTH = 420;
+
+    struct Label {
+        std::shared_ptr<SDL_Texture> texture;
+        int w = 0, h = 0;
+    };
+
+    Profiler() = default;
+
+    Label renderLabel(SDL_Renderer* renderer, const char* text) {
+        Label label;
+        if (!font) {
+            if (!TTF_WasInit() && TTF_Init() == -1) return label;
+            font.reset(TTF_OpenFont(UI_FONT.c_str(), 10), TTF_CloseFont);
+            if (!font) return label;
+        }
+
+        SDL_Surface* surface = TTF_RenderText_Blended(font.get(), text, {238, 238, 238, 255});
+        if (!surface) return label;
+
+        label.texture.reset(SDL_CreateTextureFromSurface(renderer, surface), SDL_DestroyTexture);
+        label.w = surface->w;
+        label.h = surface->h;
+        SDL_FreeSurface(surface);
+        return label;
+    }
+
+    std::vector<const char*> zone_names;
+    std::array<ProfileFrame, PROFILE_HISTORY> history{};
+    ProfileFrame current;
+    Uint64 frame_start = 0;
+    size_t frame_count = 0;
+
+    bool overlay_visible = false;
+    std::shared_ptr<TTF_Font> font;
+    std::vector<Label> labels;
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(int zone) : zone(zone), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileZone() { Profiler::instance().add(zone, SDL_GetPerformanceCounter() - start); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    int zone;
+    Uint64 start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(profile_zone_id_, __LINE__) = Profiler::instance().registerZone(name); \
+    ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(PROFILE_CONCAT(profile_zone_id_, __LINE__))
+#define PROFILE_FRAME_BEGIN() Profiler::instance().beginFrame()
+#define PROFILE_FRAME_END() Profiler::instance().endFrame()
+#define PROFILE_HANDLE_EVENT(event) Profiler::instance().handleEvent(event)
+#define PROFILE_DRAW_OVERLAY(renderer) Profiler::instance().drawOverlay(renderer)
+#define PROFILE_DUMP_CSV(path) Profiler::instance().dumpCSV(path)
+#define PROFILE_SHUTDOWN() Profiler::instance().shutdown()
+#define PROFILE_ENABLED 1
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME_BEGIN()
+#define PROFILE_FRAME_END()
+#define PROFILE_HANDLE_EVENT(event)
+#define PROFILE_DRAW_OVERLAY(renderer)
+#define PROFILE_DUMP_CSV(path)
+#define PROFILE_SHUTDOWN()
+#define PROFILE_ENABLED 0
+
+#endif
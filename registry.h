@@ -0,0 +1,50 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Enemy;
+class Tile;
+class Weapon;
+class Player;
+
+// Unordered list of shared sprites with an index by pointer, so erase() is O(1):
+// it swaps the last element into the hole.
+template <typename T>
+class SpriteList {
+public:
+    void push_back(std::shared_ptr<T> item) {
+        index[item.get()] = items.size();
+        items.push_back(std::move(item));
+    }
+
+    void erase(const T* item) {
+        auto it = index.find(item);
+        if (it == index.end()) return;
+        size_t position = it->second;
+        index.erase(it);
+        if (position != items.size() - 1) {
+            items[position] = std::move(items.back());
+            index[items[position].get()] = position;
+        }
+        items.pop_back();
+    }
+
+    size_t size() const { return items.size(); }
+    const std::shared_ptr<T>& operator[](size_t i) const { return items[i]; }
+    typename std::vector<std::shared_ptr<T>>::const_iterator begin() const { return items.begin(); }
+    typename std::vector<std::shared_ptr<T>>::const_iterator end() const { return items.end(); }
+
+private:
+    std::vector<std::shared_ptr<T>> items;
+    std::unordered_map<const T*, size_t> index;
+};
+
+// Sprites by concrete kind. The create* factories register what they build, so
+// level logic walks typed lists instead of casting its way through SpriteGroups.
+struct SpriteRegistry {
+    SpriteList<Enemy> enemies;
+    SpriteList<Tile> tiles;
+    SpriteList<Weapon> weapons;
+    std::shared_ptr<Player> player;
+};
@@ -6,7 +6,12 @@
 const int WIDTH = 1280;
 const int HEIGHT = 720;
 const int FPS = 60;
+const int TICK_RATE = 60;              // fixed simulation ticks per second
+const double MAX_FRAME_MS = 250.0;     // longer frames (stalls, breakpoints) are clamped to this
+const int MAX_TICKS_PER_FRAME = 8;     // simulation never runs more than this many ticks per render
 const int TILESIZE = 64;
+const float KNOCKBACK_DECAY = 0.8f;     // fraction of knockback velocity kept each tick
+const int STATIC_CHUNK_SIZE = TILESIZE * 8;  // pixels per side of a baked static-layer chunk
 
 struct PlayerStats {
     int health = 100;
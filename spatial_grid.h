@@ -0,0 +1,217 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "sprite.h"
+#include "settings.h"
+#include "depth_sort.h"
+
+// Category bits stored with each grid entry so queries can skip unrelated sprites.
+// The render grid tags entries static/dynamic, the combat grid by gameplay role.
+enum GridMask : unsigned int {
+    GRID_STATIC       = 1u << 0,
+    GRID_DYNAMIC      = 1u << 1,
+    GRID_ENEMY        = 1u << 2,
+    GRID_DESTRUCTIBLE = 1u << 3,
+    GRID_PLAYER       = 1u << 4,
+    GRID_ALL          = ~0u
+};
+
+// Which of a sprite's rects a grid indexes
+enum class GridBounds {
+    Rect,    // drawn area, for culling
+    Hitbox   // collision area, for gameplay queries
+};
+
+// Uniform grid over the map used to find sprites overlapping a rect without
+// touching the rest of the map. Each entry caches its rect (or hitbox), so queries never
+// call back into the sprite; static sprites are inserted once, moving ones are
+// refreshed with update() and only re-bucketed when they cross a cell boundary.
+// Positions outside the map are clamped into the border cells.
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+
+    SpatialGrid(SDL_Rect world, int cell_size = TILESIZE * 4, GridBounds bounds = GridBounds::Rect)
+        : world(world), cell_size(cell_size), bounds(bounds) {
+        columns = std::max(1, (world.w + cell_size - 1) / cell_size);
+        rows = std::max(1, (world.h + cell_size - 1) / cell_size);
+        cells.resize(static_cast<size_t>(columns) * rows);
+    }
+
+    void insert(Sprite* sprite, unsigned int mask = GRID_DYNAMIC) {
+        if (lookup.count(sprite)) return;
+
+        int index;
+        if (!free_entries.empty()) {
+            index = free_entries.back();
+            free_entries.pop_back();
+        } else {
+            index = static_cast<int>(entries.size());
+            entries.emplace_back();
+        }
+
+        Entry& entry = entries[index];
+        entry.sprite = sprite;
+        entry.rect = boundsOf(sprite);
+        entry.range = cellRange(entry.rect);
+        entry.stamp = 0;
+        entry.mask = mask;
+        if (mask & GRID_STATIC) static_version++;
+        lookup[sprite] = index;
+        link(index);
+    }
+
+    void update(Sprite* sprite) {
+        auto it = lookup.find(sprite);
+        if (it == lookup.end()) return;
+
+        Entry& entry = entries[it->second];
+        entry.rect = boundsOf(sprite);
+        CellRange range = cellRange(entry.rect);
+        if (range == entry.range) return;
+
+        unlink(it->second);
+        entry.range = range;
+        link(it->second);
+    }
+
+    void remove(Sprite* sprite) {
+        auto it = lookup.find(sprite);
+        if (it == lookup.end()) return;
+
+        int index = it->second;
+        unlink(index);
+        if (entries[index].mask & GRID_STATIC) static_version++;
+        entries[index].sprite = nullptr;
+        entries[index].mask = 0;
+        free_entries.push_back(index);
+        lookup.erase(it);
+    }
+
+    // Appends every sprite whose rect intersects `area` to `out`, each at most once.
+    void query(const SDL_Rect& area, std::vector<Sprite*>& out, unsigned int mask = GRID_ALL) {
+        visit(area, mask, [&](int index) { out.push_back(entries[index].sprite); });
+    }
+
+    // Same as query(), but emits depth keys (rect bottom, entry index) from the cached rects.
+    void queryDepth(const SDL_Rect& area, std::vector<DepthKey>& out, unsigned int mask = GRID_ALL) {
+        visit(area, mask, [&](int index) {
+            const SDL_Rect& rect = entries[index].rect;
+            out.push_back({ rect.y + rect.h, index });
+        });
+    }
+
+    Sprite* spriteAt(int index) const { return entries[index].sprite; }
+    const SDL_Rect& rectAt(int index) const { return entries[index].rect; }
+
+    // Area covered by the cells overlapping `area`; stays the same while `area`
+    // moves within those cells.
+    SDL_Rect cellBounds(const SDL_Rect& area) const {
+        CellRange range = cellRange(area);
+        return {
+            world.x + range.col0 * cell_size,
+            world.y + range.row0 * cell_size,
+            (range.col1 - range.col0 + 1) * cell_size,
+            (range.row1 - range.row0 + 1) * cell_size
+        };
+    }
+
+    // Bumped whenever a GRID_STATIC entry is added or removed.
+    unsigned int staticVersion() const { return static_version; }
+
+    size_t size() const { return lookup.size(); }
+
+private:
+    struct CellRange {
+        int col0 = 0, row0 = 0, col1 = -1, row1 = -1;
+
+        bool operator==(const CellRange& other) const {
+            return col0 == other.col0 && row0 == other.row0 &&
+                   col1 == other.col1 && row1 == other.row1;
+        }
+    };
+
+    struct Entry {
+        Sprite* sprite = nullptr;
+        SDL_Rect rect{0, 0, 0, 0};
+        CellRange range;
+        unsigned int stamp = 0;
+        unsigned int mask = 0;
+    };
+
+    template <typename Visitor>
+    void visit(const SDL_Rect& area, unsigned int mask, Visitor&& visitor) {
+        if (cells.empty()) return;
+
+        CellRange range = cellRange(area);
+        ++query_stamp;
+
+        for (int row = range.row0; row <= range.row1; ++row) {
+            for (int col = range.col0; col <= range.col1; ++col) {
+                for (int index : cells[static_cast<size_t>(row) * columns + col]) {
+                    Entry& entry = entries[index];
+                    if (entry.stamp == query_stamp || !(entry.mask & mask)) continue;
+                    entry.stamp = query_stamp;
+
+                    if (SDL_HasIntersection(&entry.rect, &area)) {
+                        visitor(index);
+                    }
+                }
+            }
+        }
+    }
+
+    SDL_Rect boundsOf(Sprite* sprite) const {
+        return bounds == GridBounds::Hitbox ? sprite->getHitbox() : sprite->getRect();
+    }
+
+    int clampColumn(int x) const { return std::clamp((x - world.x) / cell_size, 0, columns - 1); }
+    int clampRow(int y) const { return std::clamp((y - world.y) / cell_size, 0, rows - 1); }
+
+    CellRange cellRange(const SDL_Rect& rect) const {
+        return {
+            clampColumn(rect.x),
+            clampRow(rect.y),
+            clampColumn(rect.x + rect.w - 1),
+            clampRow(rect.y + rect.h - 1)
+        };
+    }
+
+    void link(int index) {
+        const CellRange& range = entries[index].range;
+        for (int row = range.row0; row <= range.row1; ++row) {
+            for (int col = range.col0; col <= range.col1; ++col) {
+                cells[static_cast<size_t>(row) * columns + col].push_back(index);
+            }
+        }
+    }
+
+    void unlink(int index) {
+        const CellRange& range = entries[index].range;
+        for (int row = range.row0; row <= range.row1; ++row) {
+            for (int col = range.col0; col <= range.col1; ++col) {
+                auto& cell = cells[static_cast<size_t>(row) * columns + col];
+                auto it = std::find(cell.begin(), cell.end(), index);
+                if (it != cell.end()) {
+                    *it = cell.back();
+                    cell.pop_back();
+                }
+            }
+        }
+    }
+
+    SDL_Rect world{0, 0, 0, 0};
+    int cell_size = TILESIZE * 4;
+    GridBounds bounds = GridBounds::Rect;
+    int columns = 0;
+    int rows = 0;
+
+    std::vector<std::vector<int>> cells;
+    std::vector<Entry> entries;
+    std::vector<int> free_entries;
+    std::unordered_map<Sprite*, int> lookup;
+    unsigned int query_stamp = 0;
+    unsigned int static_version = 0;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "sprite.h"
+#include "settings.h"
+#include "collision_grid.h"
+
+// Hash grid for moving entities, rebuilt from scratch every tick.
+//
+// Entries are bucketed by the cell holding their center and laid out
+// contiguously per bucket with a counting sort, so a rebuild is two linear
+// passes and a query reads a handful of short runs. Queries widen the area by
+// the largest half-extent inserted, so rects up to any size are found from
+// their center cell alone. Cells outside the map are fine: they just hash.
+class SpatialHash {
+public:
+    explicit SpatialHash(int cell_size = TILESIZE * 2) : cell_size(cell_size) {}
+
+    void clear() {
+        pending.clear();
+        max_half_w = 0;
+        max_half_h = 0;
+    }
+
+    void insert(Sprite* sprite, const SDL_Rect& rect) {
+        Entry entry;
+        entry.sprite = sprite;
+        entry.rect = rect;
+        entry.col = CollisionGrid::floorDiv(rect.x + rect.w / 2, cell_size);
+        entry.row = CollisionGrid::floorDiv(rect.y + rect.h / 2, cell_size);
+        pending.push_back(entry);
+
+        max_half_w = std::max(max_half_w, (rect.w + 1) / 2);
+        max_half_h = std::max(max_half_h, (rect.h + 1) / 2);
+    }
+
+    // Sorts everything inserted since clear() into buckets; call before querying.
+    void build() {
+        size_t wanted = 64;
+        while (wanted < pending.size() * 2) wanted <<= 1;
+        bucket_mask = wanted - 1;
+
+        starts.assign(wanted + 1, 0);
+        for (Entry& entry : pending) {
+            entry.bucket = bucketOf(entry.col, entry.row);
+            starts[entry.bucket + 1]++;
+        }
+        for (size_t i = 1; i < starts.size(); ++i) starts[i] += starts[i - 1];
+
+        entries.resize(pending.size());
+        cursor.assign(starts.begin(), starts.end() - 1);
+        for (const Entry& entry : pending) entries[cursor[entry.bucket]++] = entry;
+    }
+
+    // Calls visitor(sprite, rect) for every entry whose rect overlaps `area`, each exactly once.
+    template <typename Visitor>
+    void query(const SDL_Rect& area, Visitor&& visitor) const {
+        if (entries.empty()) return;
+
+        int col0 = CollisionGrid::floorDiv(area.x - max_half_w, cell_size);
+        int row0 = CollisionGrid::floorDiv(area.y - max_half_h, cell_size);
+        int col1 = CollisionGrid::floorDiv(area.x + area.w - 1 + max_half_w, cell_size);
+        int row1 = CollisionGrid::floorDiv(area.y + area.h - 1 + max_half_h, cell_size);
+
+        for (int row = row0; row <= row1; ++row) {
+            for (int col = col0; col <= col1; ++col) {
+                size_t bucket = bucketOf(col, row);
+                for (uint32_t i = starts[bucket]; i < starts[bucket + 1]; ++i) {
+                    const Entry& entry = entries[i];
+                    // Buckets are shared by every cell hashing to them
+                    if (entry.col != col || entry.row != row) continue;
+                    if (SDL_HasIntersection(&entry.rect, &area)) visitor(entry.sprite, entry.rect);
+                }
+            }
+        }
+    }
+
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        Sprite* sprite = nullptr;
+        SDL_Rect rect{0, 0, 0, 0};
+        int col = 0;
+        int row = 0;
+        size_t bucket = 0;
+    };
+
+    size_t bucketOf(int col, int row) const {
+        uint32_t h = static_cast<uint32_t>(col) * 73856093u ^ static_cast<uint32_t>(row) * 19349663u;
+        return h & bucket_mask;
+    }
+
+    int cell_size;
+    int max_half_w = 0;
+    int max_half_h = 0;
+    size_t bucket_mask = 0;
+
+    std::vector<Entry> pending;
+    std::vector<Entry> entries;     // grouped by bucket
+    std::vector<uint32_t> starts;   // entries[starts[b] .. starts[b + 1]) belong to bucket b
+    std::vector<uint32_t> cursor;
+};
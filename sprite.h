@@ -3,31 +3,135 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include "sprite_batch.h"
+
+// `rect` in world space moved into the view whose top-left is `offset`
+SDL_Rect screen_rect(const SDL_Rect& rect, SDL_Point offset) {
+    return { rect.x - offset.x, rect.y - offset.y, rect.w, rect.h };
+}
 
 class Sprite {
 public:
     virtual void update() = 0;
     virtual void draw(SDL_Renderer* renderer, SDL_Point offset) = 0;
+
+    // Queue this sprite's quads into the batch: getTexture() stretched over
+    // getRect(). Sprites without a texture flush what is queued so far and
+    // draw themselves directly.
+    virtual void submit(SpriteBatch& batch, SDL_Point offset) {
+        if (SDL_Texture* texture = getTexture()) {
+            batch.push(texture, screen_rect(getRect(), offset));
+            return;
+        }
+        batch.flush();
+        draw(batch.getRenderer(), offset);
+        batch.countDrawCall();
+    }
+
+    // Where the sprite should appear relative to its simulated position, `alpha`
+    // of the way from the previous tick to `tick`, the last one simulated.
+    // Static sprites don't move.
+    virtual SDL_Point renderDelta(float /*alpha*/, Uint32 /*tick*/) const { return {0, 0}; }
+
     virtual SDL_Rect getRect() const = 0;
     virtual SDL_Rect getHitbox() const = 0;
+    virtual SDL_Texture* getTexture() const { return nullptr; }
     virtual std::string getType() { return "generic"; }
     virtual ~Sprite() = default;
 };
 
+// Identifies a sprite's membership in one SpriteGroup. The generation changes
+// when the slot is reused, so handles to removed sprites are simply stale.
+struct SpriteHandle {
+    uint32_t slot = ~0u;
+    uint32_t generation = 0;
+};
+
+// Sprites packed contiguously for iteration, with a slot table mapping handles
+// to their position. Removal is queued and applied by flush() with a swap-and-pop,
+// so it is O(1) and safe while iterating getSprites(); the group's reference
+// (and possibly the sprite) is released at the flush. Order is not preserved.
 class SpriteGroup {
 public:
-    void add(std::shared_ptr<Sprite> sprite) {
-        sprites.push_back(sprite);
+    SpriteHandle add(std::shared_ptr<Sprite> sprite) {
+        auto it = lookup.find(sprite.get());
+        if (it != lookup.end()) {
+            slots[it->second].pending = false;  // re-added before the flush: keep it
+            return { it->second, slots[it->second].generation };
+        }
+
+        uint32_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        slots[slot].dense = static_cast<uint32_t>(sprites.size());
+        lookup[sprite.get()] = slot;
+        dense_slots.push_back(slot);
+        sprites.push_back(std::move(sprite));
+        return { slot, slots[slot].generation };
+    }
+
+    // Queued until flush(); stale handles and repeated removals are ignored.
+    void remove(SpriteHandle handle) {
+        if (!contains(handle)) return;
+        Slot& slot = slots[handle.slot];
+        if (slot.pending) return;
+        slot.pending = true;
+        pending.push_back(handle.slot);
+    }
+
+    void remove(const std::shared_ptr<Sprite>& sprite) {
+        auto it = lookup.find(sprite.get());
+        if (it == lookup.end()) return;
+        remove(SpriteHandle{ it->second, slots[it->second].generation });
+    }
+
+    bool contains(SpriteHandle handle) const {
+        return handle.slot < slots.size() && slots[handle.slot].generation == handle.generation &&
+               slots[handle.slot].dense != NO_POSITION;
+    }
+
+    Sprite* get(SpriteHandle handle) const {
+        return contains(handle) ? sprites[slots[handle.slot].dense].get() : nullptr;
     }
 
-    void remove(std::shared_ptr<Sprite> sprite) {
-        sprites.erase(std::remove_if(sprites.begin(), sprites.end(),
-            [&sprite](const std::shared_ptr<Sprite>& s) {
-                return s.get() == sprite.get();
-            }),
-            sprites.end());
+    // Owning pointer for a member (one queued for removal included), or null
+    std::shared_ptr<Sprite> find(Sprite* sprite) const {
+        auto it = lookup.find(sprite);
+        return it != lookup.end() ? sprites[slots[it->second].dense] : nullptr;
     }
 
+    // Applies queued removals; call at the end of a tick, outside any iteration.
+    void flush() {
+        for (uint32_t index : pending) {
+            Slot& slot = slots[index];
+            if (!slot.pending) continue;
+            uint32_t position = slot.dense;
+            uint32_t last = static_cast<uint32_t>(sprites.size()) - 1;
+
+            lookup.erase(sprites[position].get());
+            if (position != last) {
+                sprites[position] = std::move(sprites[last]);
+                dense_slots[position] = dense_slots[last];
+                slots[dense_slots[position]].dense = position;
+            }
+            sprites.pop_back();
+            dense_slots.pop_back();
+
+            slot.dense = NO_POSITION;
+            slot.pending = false;
+            slot.generation++;
+            free_slots.push_back(index);
+        }
+        pending.clear();
+    }
 
     void update() {
         for (auto& sprite : sprites) {
@@ -46,5 +150,18 @@ public:
     }
 
 private:
+    static const uint32_t NO_POSITION = ~0u;
+
+    struct Slot {
+        uint32_t dense = NO_POSITION;  // position in `sprites`
+        uint32_t generation = 0;
+        bool pending = false;          // queued for removal
+    };
+
     std::vector<std::shared_ptr<Sprite>> sprites;
+    std::vector<uint32_t> dense_slots;  // slot of each entry in `sprites`
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_slots;
+    std::vector<uint32_t> pending;
+    std::unordered_map<Sprite*, uint32_t> lookup;
 };
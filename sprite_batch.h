@@ -0,0 +1,269 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+const int ATLAS_PAGE_SIZE = 2048;
+const int ATLAS_MAX_ENTRY = 256;  // larger textures are drawn from their own texture
+const int ATLAS_PADDING = 1;      // transparent gutter so filtering never samples a neighbour
+
+struct AtlasRegion {
+    SDL_Texture* page = nullptr;
+    SDL_Rect src{0, 0, 0, 0};
+};
+
+// Packs small sprite textures into shared render-target pages (simple shelf
+// packing) so that quads from different animations can share one draw call.
+// Copies happen on the GPU; textures are queued by request() and packed at the
+// start of the next frame, before anything else has been drawn.
+class TextureAtlas {
+public:
+    explicit TextureAtlas(SDL_Renderer* renderer) : renderer(renderer) {
+        enabled = SDL_RenderTargetSupported(renderer);
+    }
+
+    const AtlasRegion* find(SDL_Texture* texture) const {
+        auto it = regions.find(texture);
+        return it != regions.end() ? &it->second : nullptr;
+    }
+
+    void request(SDL_Texture* texture) {
+        if (!enabled || regions.count(texture)) return;
+        if (std::find(pending.begin(), pending.end(), texture) != pending.end()) return;
+
+        int w = 0, h = 0;
+        SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+        if (w > ATLAS_MAX_ENTRY || h > ATLAS_MAX_ENTRY) return;
+
+        pending.push_back(texture);
+    }
+
+    // Textures are only ever referenced by raw pointer, so this must run before
+    // any queued texture could have been destroyed, i.e. on the very next frame.
+    void pack() {
+        if (pending.empty()) return;
+
+        SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+        for (SDL_Texture* texture : pending) {
+            int w = 0, h = 0;
+            SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+
+            SDL_Rect slot;
+            if (!allocate(w, h, slot)) break;
+
+            SDL_BlendMode blend;
+            SDL_GetTextureBlendMode(texture, &blend);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+            SDL_SetRenderTarget(renderer, pages.back().get());
+            SDL_RenderCopy(renderer, texture, nullptr, &slot);
+            SDL_SetTextureBlendMode(texture, blend);
+
+            regions[texture] = { pages.back().get(), slot };
+        }
+        SDL_SetRenderTarget(renderer, previous_target);
+        pending.clear();
+    }
+
+    // Page contents are lost on a device reset; everything is re-packed on demand.
+    void reset() {
+        regions.clear();
+        pending.clear();
+        pages.clear();
+    }
+
+    // Forget a texture that is about to be destroyed so its pointer can't alias a new one.
+    void forget(SDL_Texture* texture) {
+        regions.erase(texture);
+        pending.erase(std::remove(pending.begin(), pending.end(), texture), pending.end());
+    }
+
+    size_t pageCount() const { return pages.size(); }
+
+private:
+    // `slot` is the texture's own area; the cell reserved for it is ATLAS_PADDING larger on every side
+    bool allocate(int w, int h, SDL_Rect& slot) {
+        int cell_w = w + 2 * ATLAS_PADDING;
+        int cell_h = h + 2 * ATLAS_PADDING;
+        if (pages.empty() || !fits(cell_w, cell_h)) {
+            if (!pages.empty() && shelf_y + shelf_h + cell_h <= ATLAS_PAGE_SIZE) {
+                shelf_y += shelf_h;
+                shelf_x = 0;
+                shelf_h = 0;
+            } else if (!addPage()) {
+                return false;
+            }
+        }
+
+        slot = { shelf_x + ATLAS_PADDING, shelf_y + ATLAS_PADDING, w, h };
+        shelf_x += cell_w;
+        shelf_h = std::max(shelf_h, cell_h);
+        return true;
+    }
+
+    bool fits(int w, int h) const {
+        return shelf_x + w <= ATLAS_PAGE_SIZE && shelf_y + h <= ATLAS_PAGE_SIZE;
+    }
+
+    bool addPage() {
+        std::shared_ptr<SDL_Texture> page(
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                              ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE),
+            SDL_DestroyTexture);
+        if (!page) {
+            std::cerr << "TextureAtlas: failed to create atlas page: " << SDL_GetError() << std::endl;
+            enabled = false;
+            return false;
+        }
+        SDL_SetTextureBlendMode(page.get(), SDL_BLENDMODE_BLEND);
+
+        SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+        Uint8 r, g, b, a;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_SetRenderTarget(renderer, page.get());
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        SDL_SetRenderTarget(renderer, previous_target);
+
+        pages.push_back(std::move(page));
+        shelf_x = shelf_y = shelf_h = 0;
+        return true;
+    }
+
+    SDL_Renderer* renderer = nullptr;
+    bool enabled = false;
+    std::vector<std::shared_ptr<SDL_Texture>> pages;
+    std::unordered_map<SDL_Texture*, AtlasRegion> regions;
+    std::vector<SDL_Texture*> pending;
+    int shelf_x = 0, shelf_y = 0, shelf_h = 0;
+};
+
+// Collects textured quads for a frame and submits them with SDL_RenderGeometry,
+// one call per run of quads sharing a texture (usually an atlas page). Quads are
+// ordered by (depth, texture) so equal-depth sprites don't force texture switches.
+class SpriteBatch {
+public:
+    explicit SpriteBatch(SDL_Renderer* renderer) : renderer(renderer), atlas(renderer) {}
+
+    void begin() {
+        atlas.pack();
+        quads.clear();
+        draw_calls = 0;
+        depth = 0;
+    }
+
+    void setDepth(int value) { depth = value; }
+
+    void push(SDL_Texture* texture, const SDL_Rect& dst, SDL_Color color = {255, 255, 255, 255}) {
+        if (!texture) return;
+
+        Quad quad;
+        quad.depth = depth;
+        quad.order = static_cast<int>(quads.size());
+        quad.dst = dst;
+        quad.color = color;
+
+        if (const AtlasRegion* region = atlas.find(texture)) {
+            quad.texture = region->page;
+            quad.src = region->src;
+            quad.tex_w = ATLAS_PAGE_SIZE;
+            quad.tex_h = ATLAS_PAGE_SIZE;
+        } else {
+            atlas.request(texture);
+            int w = 0, h = 0;
+            SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+            quad.texture = texture;
+            quad.src = { 0, 0, w, h };
+            quad.tex_w = w;
+            quad.tex_h = h;
+        }
+
+        quads.push_back(quad);
+    }
+
+    void flush() {
+        if (quads.empty()) return;
+
+        std::sort(quads.begin(), quads.end(), [](const Quad& a, const Quad& b) {
+            if (a.depth != b.depth) return a.depth < b.depth;
+            if (a.texture != b.texture) return a.texture < b.texture;
+            return a.order < b.order;
+        });
+
+        size_t run_start = 0;
+        while (run_start < quads.size()) {
+            size_t run_end = run_start;
+            vertices.clear();
+            indices.clear();
+
+            while (run_end < quads.size() && quads[run_end].texture == quads[run_start].texture) {
+                appendQuad(quads[run_end]);
+                ++run_end;
+            }
+
+            SDL_RenderGeometry(renderer, quads[run_start].texture,
+                               vertices.data(), static_cast<int>(vertices.size()),
+                               indices.data(), static_cast<int>(indices.size()));
+            draw_calls++;
+            run_start = run_end;
+        }
+
+        quads.clear();
+    }
+
+    void handleEvent(const SDL_Event& event) {
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            atlas.reset();
+        }
+    }
+
+    SDL_Renderer* getRenderer() const { return renderer; }
+    TextureAtlas& getAtlas() { return atlas; }
+
+    // Draw calls issued since begin(); a sprite drawing itself directly should
+    // count itself through countDrawCall().
+    int drawCalls() const { return draw_calls; }
+    void countDrawCall() { draw_calls++; }
+
+private:
+    struct Quad {
+        SDL_Texture* texture = nullptr;
+        SDL_Rect src;
+        SDL_Rect dst;
+        SDL_Color color;
+        int tex_w = 1, tex_h = 1;
+        int depth = 0;
+        int order = 0;
+    };
+
+    void appendQuad(const Quad& quad) {
+        float u0 = static_cast<float>(quad.src.x) / quad.tex_w;
+        float v0 = static_cast<float>(quad.src.y) / quad.tex_h;
+        float u1 = static_cast<float>(quad.src.x + quad.src.w) / quad.tex_w;
+        float v1 = static_cast<float>(quad.src.y + quad.src.h) / quad.tex_h;
+
+        float x0 = static_cast<float>(quad.dst.x);
+        float y0 = static_cast<float>(quad.dst.y);
+        float x1 = static_cast<float>(quad.dst.x + quad.dst.w);
+        float y1 = static_cast<float>(quad.dst.y + quad.dst.h);
+
+        int base = static_cast<int>(vertices.size());
+        vertices.push_back({ { x0, y0 }, quad.color, { u0, v0 } });
+        vertices.push_back({ { x1, y0 }, quad.color, { u1, v0 } });
+        vertices.push_back({ { x1, y1 }, quad.color, { u1, v1 } });
+        vertices.push_back({ { x0, y1 }, quad.color, { u0, v1 } });
+
+        indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+
+    SDL_Renderer* renderer = nullptr;
+    TextureAtlas atlas;
+    std::vector<Quad> quads;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    int depth = 0;
+    int draw_calls = 0;
+};
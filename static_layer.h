@@ -0,0 +1,179 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "sprite.h"
+#include "settings.h"
+
+// Pre-renders the floor image and every flat tile into fixed-size render-target
+// chunks, so the static part of the map costs one SDL_RenderCopy per visible chunk.
+// Falls back to drawing the flat sprites one by one when render targets are unsupported.
+class StaticLayer {
+public:
+    StaticLayer(SDL_Renderer* renderer,
+                std::shared_ptr<SDL_Texture> floor_texture,
+                SDL_Rect floor_rect,
+                const SpriteGroup* flat_group)
+        : renderer(renderer), floor_texture(std::move(floor_texture)),
+          floor_rect(floor_rect), flatGroup(flat_group) {
+
+        bounds = floor_rect;
+        for (const auto& sprite : flatGroup->getSprites()) {
+            SDL_Rect rect = sprite->getRect();
+            SDL_UnionRect(&bounds, &rect, &bounds);
+        }
+
+        columns = (bounds.w + STATIC_CHUNK_SIZE - 1) / STATIC_CHUNK_SIZE;
+        rows = (bounds.h + STATIC_CHUNK_SIZE - 1) / STATIC_CHUNK_SIZE;
+
+        baked = SDL_RenderTargetSupported(renderer);
+        if (!baked) {
+            std::cerr << "StaticLayer: render targets unsupported, drawing flat tiles individually\n";
+            return;
+        }
+
+        chunks.resize(static_cast<size_t>(columns) * rows);
+        rebuild(bounds);
+    }
+
+    // Re-bakes every chunk overlapping `area`, e.g. after a flat tile was removed.
+    // Also used to restore chunk contents after SDL_RENDER_TARGETS_RESET.
+    void rebuild(const SDL_Rect& area) {
+        if (!baked) return;
+
+        SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                SDL_Rect chunk_rect = chunkRect(col, row);
+                if (SDL_HasIntersection(&chunk_rect, &area)) {
+                    bakeChunk(col, row);
+                }
+            }
+        }
+        SDL_SetRenderTarget(renderer, previous_target);
+    }
+
+    void rebuildAll() { rebuild(bounds); }
+
+    // Returns the number of draw calls issued.
+    int draw(const SDL_Rect& view, SDL_Point offset) {
+        if (!baked) return drawUnbaked(view, offset);
+
+        int draw_calls = 0;
+        int first_col = std::max(0, (view.x - bounds.x) / STATIC_CHUNK_SIZE);
+        int first_row = std::max(0, (view.y - bounds.y) / STATIC_CHUNK_SIZE);
+        int last_col = std::min(columns - 1, (view.x + view.w - bounds.x) / STATIC_CHUNK_SIZE);
+        int last_row = std::min(rows - 1, (view.y + view.h - bounds.y) / STATIC_CHUNK_SIZE);
+
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int col = first_col; col <= last_col; ++col) {
+                const auto& chunk = chunks[static_cast<size_t>(row) * columns + col];
+                if (!chunk) continue;
+
+                SDL_Rect rect = chunkRect(col, row);
+                SDL_Rect shifted = { rect.x - offset.x, rect.y - offset.y, rect.w, rect.h };
+                SDL_RenderCopy(renderer, chunk.get(), nullptr, &shifted);
+                draw_calls++;
+            }
+        }
+        return draw_calls;
+    }
+
+    bool isBaked() const { return baked; }
+
+private:
+    SDL_Rect chunkRect(int col, int row) const {
+        return {
+            bounds.x + col * STATIC_CHUNK_SIZE,
+            bounds.y + row * STATIC_CHUNK_SIZE,
+            STATIC_CHUNK_SIZE,
+            STATIC_CHUNK_SIZE
+        };
+    }
+
+    void bakeChunk(int col, int row) {
+        auto& chunk = chunks[static_cast<size_t>(row) * columns + col];
+        SDL_Rect rect = chunkRect(col, row);
+
+        std::vector<Sprite*> contents;
+        for (const auto& sprite : flatGroup->getSprites()) {
+            SDL_Rect sprite_rect = sprite->getRect();
+            if (SDL_HasIntersection(&sprite_rect, &rect)) contents.push_back(sprite.get());
+        }
+        bool has_floor = floor_texture && SDL_HasIntersection(&floor_rect, &rect);
+
+        if (contents.empty() && !has_floor) {
+            chunk.reset();
+            return;
+        }
+
+        if (!chunk) {
+            chunk.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                          STATIC_CHUNK_SIZE, STATIC_CHUNK_SIZE),
+                        SDL_DestroyTexture);
+            if (!chunk) {
+                std::cerr << "StaticLayer: failed to create chunk texture: " << SDL_GetError() << std::endl;
+                exit(1);
+            }
+            SDL_SetTextureBlendMode(chunk.get(), SDL_BLENDMODE_BLEND);
+        }
+
+        SDL_SetRenderTarget(renderer, chunk.get());
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+
+        SDL_Point origin = { rect.x, rect.y };
+        if (has_floor) {
+            SDL_Rect shifted_floor = {
+                floor_rect.x - origin.x,
+                floor_rect.y - origin.y,
+                floor_rect.w,
+                floor_rect.h
+            };
+            SDL_RenderCopy(renderer, floor_texture.get(), nullptr, &shifted_floor);
+        }
+
+        std::sort(contents.begin(), contents.end(), [](const Sprite* a, const Sprite* b) {
+            return (a->getRect().y + a->getRect().h) < (b->getRect().y + b->getRect().h);
+        });
+        for (Sprite* sprite : contents) {
+            sprite->draw(renderer, origin);
+        }
+    }
+
+    int drawUnbaked(const SDL_Rect& view, SDL_Point offset) {
+        int draw_calls = 0;
+        if (floor_texture) {
+            SDL_Rect shifted_floor = {
+                floor_rect.x - offset.x,
+                floor_rect.y - offset.y,
+                floor_rect.w,
+                floor_rect.h
+            };
+            SDL_RenderCopy(renderer, floor_texture.get(), nullptr, &shifted_floor);
+            draw_calls++;
+        }
+
+        for (const auto& sprite : flatGroup->getSprites()) {
+            SDL_Rect rect = sprite->getRect();
+            if (SDL_HasIntersection(&rect, &view)) {
+                sprite->draw(renderer, offset);
+                draw_calls++;
+            }
+        }
+        return draw_calls;
+    }
+
+    SDL_Renderer* renderer = nullptr;
+    std::shared_ptr<SDL_Texture> floor_texture;
+    SDL_Rect floor_rect;
+    const SpriteGroup* flatGroup = nullptr;
+
+    SDL_Rect bounds;
+    int columns = 0;
+    int rows = 0;
+    bool baked = false;
+    std::vector<std::shared_ptr<SDL_Texture>> chunks;
+};
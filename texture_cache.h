@@ -0,0 +1,145 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct TextureCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t decodes = 0;
+    size_t textures_resident = 0;
+    size_t bytes_resident = 0;
+};
+
+// Hands out ref-counted handles to GPU textures so that identical assets are
+// uploaded once. Entries are keyed by asset path, by an explicit string key, or
+// by SDL_Surface identity; the cache only holds weak references, so a texture is
+// destroyed (and its bytes released) as soon as the last handle goes away.
+//
+// Surface-keyed entries assume the surface outlives every handle created from it.
+// Handles may outlive the cache itself: their deleters only see the cache's
+// bookkeeping through a weak reference and skip it once the cache is gone.
+class TextureCache {
+public:
+    std::shared_ptr<SDL_Texture> load(SDL_Renderer* renderer, const std::string& path) {
+        if (auto texture = lookup(&State::by_key, path)) return texture;
+
+        SDL_Surface* surface = IMG_Load(path.c_str());
+        state->counters.decodes++;
+        if (!surface) {
+            std::cerr << "TextureCache: failed to load image: " << path << " | " << IMG_GetError() << std::endl;
+            return nullptr;
+        }
+
+        auto texture = track(&State::by_key, path, SDL_CreateTextureFromSurface(renderer, surface));
+        SDL_FreeSurface(surface);
+        return texture;
+    }
+
+    std::shared_ptr<SDL_Texture> fromSurface(SDL_Renderer* renderer, SDL_Surface* surface) {
+        if (!surface) return nullptr;
+        if (auto texture = lookup(&State::by_surface, surface)) return texture;
+
+        return track(&State::by_surface, surface, SDL_CreateTextureFromSurface(renderer, surface));
+    }
+
+    // Solid black placeholder shared by everything asking for the same key.
+    std::shared_ptr<SDL_Texture> solid(SDL_Renderer* renderer, const std::string& key, int w, int h) {
+        if (auto texture = lookup(&State::by_key, key)) return texture;
+
+        SDL_Surface* surface = SDL_CreateRGBSurface(0, w, h, 32, 0, 0, 0, 0);
+        if (!surface) {
+            std::cerr << "TextureCache: failed to create placeholder surface '" << key << "': " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+        SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, 0, 0, 0));
+
+        auto texture = track(&State::by_key, key, SDL_CreateTextureFromSurface(renderer, surface));
+        SDL_FreeSurface(surface);
+        return texture;
+    }
+
+    // Called right before a cached texture is destroyed, for anything that keys data on texture pointers.
+    void setDestroyHook(std::function<void(SDL_Texture*)> hook) { state->destroy_hook = std::move(hook); }
+
+    const TextureCacheStats& stats() const { return state->counters; }
+
+    void report(std::ostream& out) const {
+        const TextureCacheStats& counters = state->counters;
+        out << "[TextureCache] hits: " << counters.hits
+            << " | misses: " << counters.misses
+            << " | decodes: " << counters.decodes
+            << " | textures: " << counters.textures_resident
+            << " | resident: " << counters.bytes_resident / 1024 << " KB\n";
+    }
+
+private:
+    // Everything a deleter touches, shared so that handles can tell whether the cache is still alive
+    struct State {
+        std::unordered_map<std::string, std::weak_ptr<SDL_Texture>> by_key;
+        std::unordered_map<SDL_Surface*, std::weak_ptr<SDL_Texture>> by_surface;
+        TextureCacheStats counters;
+        std::function<void(SDL_Texture*)> destroy_hook;
+    };
+
+    template <typename Map, typename Key>
+    std::shared_ptr<SDL_Texture> lookup(Map State::* field, const Key& key) {
+        Map& map = (*state).*field;
+        auto it = map.find(key);
+        if (it != map.end()) {
+            if (auto texture = it->second.lock()) {
+                state->counters.hits++;
+                return texture;
+            }
+        }
+        state->counters.misses++;
+        return nullptr;
+    }
+
+    template <typename Map, typename Key>
+    std::shared_ptr<SDL_Texture> track(Map State::* field, const Key& key, SDL_Texture* raw) {
+        if (!raw) {
+            std::cerr << "TextureCache: failed to create texture: " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+
+        // Estimate assumes 4 bytes per texel, which is what SDL picks for decoded PNGs.
+        int w = 0, h = 0;
+        SDL_QueryTexture(raw, nullptr, nullptr, &w, &h);
+        size_t bytes = static_cast<size_t>(w) * static_cast<size_t>(h) * 4;
+
+        state->counters.textures_resident++;
+        state->counters.bytes_resident += bytes;
+
+        std::weak_ptr<State> owner = state;
+        std::shared_ptr<SDL_Texture> texture(raw, [owner, field, key, bytes](SDL_Texture* t) {
+            std::shared_ptr<State> cache = owner.lock();
+            if (cache && cache->destroy_hook) cache->destroy_hook(t);
+            SDL_DestroyTexture(t);
+            if (!cache) return;
+
+            cache->counters.textures_resident--;
+            cache->counters.bytes_resident -= bytes;
+            Map& map = (*cache).*field;
+            auto it = map.find(key);
+            if (it != map.end() && it->second.expired()) map.erase(it);
+        });
+
+        ((*state).*field)[key] = texture;
+        return texture;
+    }
+
+    std::shared_ptr<State> state = std::make_shared<State>();
+};
+
+SDL_Point texture_size(const std::shared_ptr<SDL_Texture>& texture) {
+    SDL_Point size = {0, 0};
+    if (texture) SDL_QueryTexture(texture.get(), nullptr, nullptr, &size.x, &size.y);
+    return size;
+}
+
+TextureCache texture_cache;
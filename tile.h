@@ -3,7 +3,9 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include "sprite.h"
+#include "registry.h"
 #include "settings.h"
+#include "texture_cache.h"
 
 class Tile : public Sprite {
 public:
@@ -12,25 +14,21 @@ public:
          SDL_Surface* surface = nullptr)
         : sprite_type(sprite_type)
     {
-        bool createdInternally = false;
-        if (!surface) {
-            surface = SDL_CreateRGBSurface(0, TILESIZE, TILESIZE, 32, 0, 0, 0, 0);
-            if (!surface) {
-                std::cerr << "Failed to create fallback RGB surface for sprite_type: " << sprite_type << std::endl;
-                exit(1);
-            }
-            createdInternally = true;
+        SDL_Point size = { TILESIZE, TILESIZE };
+        if (surface) {
+            texture = texture_cache.fromSurface(renderer, surface);
+            size = { surface->w, surface->h };
+        } else {
+            texture = texture_cache.solid(renderer, "tile:" + sprite_type, TILESIZE, TILESIZE);
         }
 
-        texture.reset(SDL_CreateTextureFromSurface(renderer, surface), SDL_DestroyTexture);
         if (!texture) {
-            std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
-            if (createdInternally) SDL_FreeSurface(surface);
+            std::cerr << "Failed to create texture for sprite_type: " << sprite_type << std::endl;
             exit(1);
         }
-        if (sprite_type == "objects" && surface->h > TILESIZE) {
-            int dy = surface->h - TILESIZE;
-            rect = { pos.x, pos.y - dy, surface->w, surface->h };
+        if (sprite_type == "objects" && size.y > TILESIZE) {
+            int dy = size.y - TILESIZE;
+            rect = { pos.x, pos.y - dy, size.x, size.y };
 
             hitbox = {
                 rect.x,
@@ -39,7 +37,7 @@ public:
                 TILESIZE
             };
         } else {
-            rect = { pos.x, pos.y, surface->w, surface->h };
+            rect = { pos.x, pos.y, size.x, size.y };
 
             int insetY = 3;
             hitbox = {
@@ -49,9 +47,6 @@ public:
                 rect.h - 2 * insetY
             };
         }
-
-
-        if (createdInternally) SDL_FreeSurface(surface);
     }
 
     void update() override {}
@@ -71,7 +66,7 @@ public:
     SDL_Rect getRect() const override { return rect; }
     std::string getType() const { return sprite_type; }
     SDL_Rect getHitbox() const override { return hitbox; }
-    std::shared_ptr<SDL_Texture> getTexture() const { return texture; }
+    SDL_Texture* getTexture() const override { return texture.get(); }
 
 private:
     std::string sprite_type;
@@ -81,10 +76,11 @@ private:
 
 };
 
-std::shared_ptr<Tile> createTile(SDL_Renderer* renderer, SDL_Point pos, std::initializer_list<SpriteGroup*> groups, const std::string& sprite_type = "", SDL_Surface* surface = nullptr) {
+std::shared_ptr<Tile> createTile(SDL_Renderer* renderer, SDL_Point pos, std::initializer_list<SpriteGroup*> groups, const std::string& sprite_type = "", SDL_Surface* surface = nullptr, SpriteRegistry* registry = nullptr) {
     auto tile = std::make_shared<Tile>(renderer, pos, sprite_type, surface);
     for (auto* group : groups) {
         group->add(tile);
     }
+    if (registry) registry->tiles.push_back(tile);
     return tile;
 }
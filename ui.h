@@ -5,9 +5,13 @@
 
 #include "settings.h"
 #include "player.h"
+#include "texture_cache.h"
+#include "profiler.h"
+#include "log.h"
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <iostream>
 
 class UI {
@@ -32,6 +36,15 @@ public:
 
         mana_back = {10, 40, MANA_BAR_WIDTH, BAR_HEIGHT};
         mana_fill = mana_back;
+
+        // Preload every HUD icon once; switching only swaps handles
+        for (const auto& name : weapons) {
+            weapon_icons.push_back(loadIcon(weapon_graphics[name] + "full.png"));
+        }
+        for (const auto& name : magic) {
+            magic_icons.push_back(loadIcon(magic_graphics[name]));
+        }
+        last_decode_count = texture_cache.stats().decodes;
     }
 
     ~UI() {
@@ -51,9 +64,20 @@ public:
         updateEXP();
         updateWeapon();
         updateMagic();
+
+        size_t decodes = texture_cache.stats().decodes;
+        decodes_this_frame = static_cast<int>(decodes - last_decode_count);
+        last_decode_count = decodes;
+        if (decodes_this_frame > 0) {
+            LOG_INFO(Assets, "%d image decode(s) this frame", decodes_this_frame);
+        }
     }
 
+    // Image decodes (IMG_Load calls through the texture cache) since the previous update()
+    int getDecodesThisFrame() const { return decodes_this_frame; }
+
 void render() {
+    PROFILE_ZONE("ui_render");
     // Background bars
     SDL_SetRenderDrawColor(renderer, 34, 34, 34, 255);
     SDL_RenderFillRect(renderer, &health_back);
@@ -112,8 +136,16 @@ private:
     // EXP caching
     int last_exp = -1;
     SDL_Texture* exp_texture = nullptr;
-    SDL_Texture* weapon_texture = nullptr;
-    SDL_Texture* magic_texture = nullptr;
+    std::shared_ptr<SDL_Texture> weapon_texture;
+    std::shared_ptr<SDL_Texture> magic_texture;
+
+    // Icon caching
+    std::vector<std::shared_ptr<SDL_Texture>> weapon_icons;
+    std::vector<std::shared_ptr<SDL_Texture>> magic_icons;
+    int last_weapon_index = -1;
+    int last_magic_index = -1;
+    size_t last_decode_count = 0;
+    int decodes_this_frame = 0;
 
     SDL_Rect exp_rect = {};
     SDL_Rect weapon_rect = {};
@@ -144,66 +176,40 @@ private:
         SDL_FreeSurface(surface);
     }
 
-    void updateWeapon() {
-        std::string full_path = weapon_graphics[weapons[player->weapon_index]] + "full.png";
-
-        SDL_Surface* surface = IMG_Load(full_path.c_str());
-        if (!surface) {
-            std::cerr << "Failed to load weapon texture: " << full_path << " | " << IMG_GetError() << std::endl;
+    std::shared_ptr<SDL_Texture> loadIcon(const std::string& path) {
+        auto texture = texture_cache.load(renderer, path);
+        if (!texture) {
+            std::cerr << "Failed to load UI icon: " << path << std::endl;
             exit(1);
         }
+        return texture;
+    }
 
-        if (weapon_texture) {
-            SDL_DestroyTexture(weapon_texture);
-            weapon_texture = nullptr;
-        }
-
-        weapon_texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (!weapon_texture) {
-            std::cerr << "Failed to create weapon texture for UI\n";
-            SDL_FreeSurface(surface);
-            exit(1);
-        }
+    void updateWeapon() {
+        if (player->weapon_index == last_weapon_index) return;
+        last_weapon_index = player->weapon_index;
 
-        int weapon_w = surface->w;
-        int weapon_h = surface->h;
-        SDL_FreeSurface(surface);
+        weapon_texture = weapon_icons[last_weapon_index];
+        SDL_Point size = texture_size(weapon_texture);
 
         // Center weapon inside the fixed weapon box
-        weapon_rect.w = weapon_w;
-        weapon_rect.h = weapon_h;
-        weapon_rect.x = weapon_box.x + (weapon_box.w - weapon_w) / 2;
-        weapon_rect.y = weapon_box.y + (weapon_box.h - weapon_h) / 2;
+        weapon_rect.w = size.x;
+        weapon_rect.h = size.y;
+        weapon_rect.x = weapon_box.x + (weapon_box.w - size.x) / 2;
+        weapon_rect.y = weapon_box.y + (weapon_box.h - size.y) / 2;
     }
 
     void updateMagic() {
-        std::string full_path = magic_graphics[magic[player->magic_index]];
-        SDL_Surface* surface = IMG_Load(full_path.c_str());
-        if (!surface) {
-            std::cerr << "Failed to load magic texture: " << full_path << " | " << IMG_GetError() << std::endl;
-            exit(1);
-        }
+        if (player->magic_index == last_magic_index) return;
+        last_magic_index = player->magic_index;
 
-        if (magic_texture) {
-            SDL_DestroyTexture(magic_texture);
-            magic_texture = nullptr;
-        }
-
-        magic_texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (!magic_texture) {
-            std::cerr << "Failed to create magic texture for UI\n";
-            SDL_FreeSurface(surface);
-            exit(1);
-        }
-
-        int magic_w = surface->w;
-        int magic_h = surface->h;
-        SDL_FreeSurface(surface);
+        magic_texture = magic_icons[last_magic_index];
+        SDL_Point size = texture_size(magic_texture);
 
-        magic_rect.w = magic_w;
-        magic_rect.h = magic_h;
-        magic_rect.x = magic_box.x + (magic_box.w - magic_w) / 2;
-        magic_rect.y = magic_box.y + (magic_box.h - magic_h) / 2;
+        magic_rect.w = size.x;
+        magic_rect.h = size.y;
+        magic_rect.x = magic_box.x + (magic_box.w - size.x) / 2;
+        magic_rect.y = magic_box.y + (magic_box.h - size.y) / 2;
     }
 
 
@@ -215,13 +221,13 @@ private:
 
     void renderWeapon() {
         if (weapon_texture) {
-            SDL_RenderCopy(renderer, weapon_texture, nullptr, &weapon_rect);
+            SDL_RenderCopy(renderer, weapon_texture.get(), nullptr, &weapon_rect);
         }
     }
 
     void renderMagic() {
         if (magic_texture) {
-            SDL_RenderCopy(renderer, magic_texture, nullptr, &magic_rect);
+            SDL_RenderCopy(renderer, magic_texture.get(), nullptr, &magic_rect);
         }
     }
 
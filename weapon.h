@@ -4,48 +4,39 @@
 #include <iostream>
 #include <memory>
 #include "sprite.h"
+#include "registry.h"
 #include "player.h"
+#include "texture_cache.h"
+#include "log.h"
 
 class Weapon : public Sprite {
 public:
     Weapon(SDL_Renderer* renderer, std::shared_ptr<Player> player, const std::string& texture_path = "") {
-        SDL_Surface* surface = nullptr;
-        bool createdInternally = false;
-        std::cout << "Weapon constructor called" << std::endl;
+        LOG_DEBUG(Combat, "weapon created");
         if (texture_path.empty()) {
-            surface = SDL_CreateRGBSurface(0, 40, 40, 32, 0, 0, 0, 0);
-            if (!surface) {
-                std::cerr << "Failed to create default weapon surface: " << SDL_GetError() << std::endl;
+            texture = texture_cache.solid(renderer, "weapon:fallback", 40, 40);
+            if (!texture) {
+                std::cerr << "Failed to create default weapon texture" << std::endl;
                 exit(1);
             }
-            SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, 0, 0, 0));
-            createdInternally = true;
         } else {
-            std::string status = player->getStatus();
-            status = status.substr(0, status.find('_'));
+            std::string status = direction_name(player->getFacing());
             std::string full_path = texture_path + status + ".png";
 
-            surface = IMG_Load(full_path.c_str());
-            if (!surface) {
-                std::cerr << "Failed to load weapon texture: " << full_path << " | " << IMG_GetError() << std::endl;
+            texture = texture_cache.load(renderer, full_path);
+            if (!texture) {
+                std::cerr << "Failed to load weapon texture: " << full_path << std::endl;
                 exit(1);
             }
         }
-
-        texture.reset(SDL_CreateTextureFromSurface(renderer, surface), SDL_DestroyTexture);
         SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
-        if (!texture) {
-            std::cerr << "Failed to create weapon texture\n";
-            if (createdInternally && surface) SDL_FreeSurface(surface);
-            exit(1);
-        }
 
         const SDL_Rect& player_rect = player->getRect();
-        rect.w = surface->w;
-        rect.h = surface->h;
+        SDL_Point size = texture_size(texture);
+        rect.w = size.x;
+        rect.h = size.y;
 
-        std::string status = player->getStatus();
-        status = status.substr(0, status.find('_'));
+        std::string status = direction_name(player->getFacing());
 
         if (status == "right") {
             rect.x = player_rect.x + player_rect.w;
@@ -62,7 +53,6 @@ public:
         }
 
         hitbox = rect;
-        if (createdInternally) SDL_FreeSurface(surface);
     }
 
     void update() override {}
@@ -80,7 +70,7 @@ public:
 
     SDL_Rect getRect() const override { return rect; }
     SDL_Rect getHitbox() const override { return hitbox; }
-    std::shared_ptr<SDL_Texture> getTexture() const { return texture; }
+    SDL_Texture* getTexture() const override { return texture.get(); }
 
     ~Weapon() {
     }
@@ -95,10 +85,12 @@ private:
 std::shared_ptr<Weapon> createWeapon(SDL_Renderer* renderer,
                                      std::shared_ptr<Player> player,
                                      std::initializer_list<SpriteGroup*> groups,
-                                     const std::string& texture_path = "") {
+                                     const std::string& texture_path = "",
+                                     SpriteRegistry* registry = nullptr) {
     auto weapon = std::make_shared<Weapon>(renderer, player, texture_path);
     for (auto* group : groups) {
         group->add(weapon);
     }
+    if (registry) registry->weapons.push_back(weapon);
     return weapon;
 }